@@ -0,0 +1,117 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file BinaryConfig.cc
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Implementación de los métodos de la clase BinaryConfig y de la función SaveBinaryConfig.
+ */
+
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "BinaryConfig.h"
+
+/**
+ * @brief Construct a new BinaryConfig:: BinaryConfig object
+ * Proyecta el archivo completo en memoria de solo lectura y comprueba la cabecera. Se avisa al
+ * sistema de que se va a leer de forma secuencial para que adelante la lectura del disco.
+ * Si algo falla, se termina el programa.
+ * @param file_name nombre del archivo
+ */
+BinaryConfig::BinaryConfig(const std::string& file_name) {
+  const int descriptor = open(file_name.c_str(), O_RDONLY);
+  if (descriptor < 0) {
+    std::cerr << "File could not be opened." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  struct stat status;
+  if (fstat(descriptor, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(ConfigHeader))) {
+    std::cerr << "The file " << file_name << " is not a valid binary configuration." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  length_ = status.st_size;
+  mapping_ = mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+  // La proyección sigue siendo válida después de cerrar el descriptor
+  close(descriptor);
+  if (mapping_ == MAP_FAILED) {
+    std::cerr << "The file " << file_name << " could not be mapped into memory." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  madvise(mapping_, length_, MADV_SEQUENTIAL);
+  header_ = static_cast<const ConfigHeader*>(mapping_);
+  cells_ = static_cast<const uint8_t*>(mapping_) + sizeof(ConfigHeader);
+  const bool valid = std::memcmp(header_->magic, kConfigMagic, sizeof(kConfigMagic)) == 0 &&
+                     header_->version == kConfigVersion && header_->header_bytes == sizeof(ConfigHeader) &&
+                     header_->size > 0 && header_->size <= INT_MAX && header_->border <= OPEN &&
+                     header_->open_state <= 1 && header_->rule <= 255 &&
+                     length_ >= sizeof(ConfigHeader) + (header_->size + 7) / 8;
+  if (!valid) {
+    std::cerr << "The file " << file_name << " is not a valid binary configuration." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+/**
+ * @brief Destroy the BinaryConfig:: BinaryConfig object
+ */
+BinaryConfig::~BinaryConfig() {
+  if (mapping_ != nullptr && mapping_ != MAP_FAILED) {
+    munmap(mapping_, length_);
+  }
+}
+
+/**
+ * @brief Método que indica si un archivo está en formato binario.
+ * Solo se leen los primeros bytes: si coinciden con la firma, es binario; si no, es de texto.
+ * @param file_name nombre del archivo
+ * @return true si el archivo empieza por la firma del formato binario
+ */
+bool BinaryConfig::IsBinary(const std::string& file_name) {
+  std::ifstream input_file{file_name, std::ios::binary};
+  char magic[sizeof(kConfigMagic)];
+  return input_file.read(magic, sizeof(magic)) && std::memcmp(magic, kConfigMagic, sizeof(magic)) == 0;
+}
+
+/**
+ * @brief Función que guarda una configuración en formato binario.
+ * Se escribe la cabecera y después las células, rellenando con ceros hasta un múltiplo de 8 bytes.
+ * @param file_name nombre del archivo de salida
+ * @param size número de células
+ * @param borderType tipo de frontera
+ * @param openState estado de la frontera abierta
+ * @param rule código de Wolfram de la regla
+ * @param cells células empaquetadas, (size + 7) / 8 bytes
+ */
+void SaveBinaryConfig(const std::string& file_name, const int& size, const BorderType& borderType,
+                      const State& openState, const int& rule, const uint8_t* cells) {
+  std::ofstream output_file{file_name, std::ios::binary};
+  if (!output_file.is_open()) {
+    std::cerr << "Unable to open file " << file_name << " for saving." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  ConfigHeader header{};
+  std::memcpy(header.magic, kConfigMagic, sizeof(kConfigMagic));
+  header.version = kConfigVersion;
+  header.header_bytes = sizeof(ConfigHeader);
+  header.size = size;
+  header.border = borderType;
+  header.open_state = openState;
+  header.rule = rule;
+  const std::size_t bytes = (static_cast<std::size_t>(size) + 7) / 8;
+  const char padding[8] = {};
+  output_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  output_file.write(reinterpret_cast<const char*>(cells), bytes);
+  output_file.write(padding, (8 - bytes % 8) % 8);
+  if (!output_file) {
+    std::cerr << "Error writing the file " << file_name << "." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file BinaryConfig.h
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Formato binario empaquetado de la configuración inicial.
+ * El archivo empieza con una cabecera de 64 bytes (firma, versión, tamaño, frontera y regla) seguida
+ * de las células a 1 bit por célula: la célula i es el bit i % 8 del byte i / 8, el mismo orden que
+ * las palabras de PackedLattice. Los datos se rellenan con ceros hasta un múltiplo de 8 bytes.
+ * En vez de leerlo, el archivo se proyecta en memoria con mmap, así que cargar una configuración de
+ * miles de millones de células es copiar bytes, sin interpretar texto.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifndef BINARYCONFIG_H
+#define BINARYCONFIG_H
+
+#include "Lattice.h"
+
+/**
+ * @brief Cabecera del formato binario, 64 bytes en little-endian
+ */
+struct ConfigHeader {
+  char magic[8]; // firma "AYEDACA1"
+  uint32_t version; // versión del formato, 1
+  uint32_t header_bytes; // tamaño de la cabecera, 64
+  uint64_t size; // número de células
+  uint32_t border; // tipo de frontera (BorderType)
+  uint32_t open_state; // estado de la frontera abierta
+  uint32_t rule; // código de Wolfram de la regla
+  uint8_t reserved[28]; // reservado, a 0
+};
+static_assert(sizeof(ConfigHeader) == 64, "La cabecera del formato binario debe ocupar 64 bytes");
+
+// Firma y versión del formato
+constexpr char kConfigMagic[8] = {'A', 'Y', 'E', 'D', 'A', 'C', 'A', '1'};
+constexpr uint32_t kConfigVersion = 1;
+
+/**
+ * @brief Clase Configuración binaria
+ * Proyecta el archivo en memoria al construirse y lo libera al destruirse. Comprueba la cabecera y
+ * que el archivo tenga todos los bytes de las células.
+ */
+class BinaryConfig {
+ public:
+  // Constructor que proyecta el archivo en memoria; termina el programa si no es válido
+  explicit BinaryConfig(const std::string& file_name);
+  // Destructor que libera la proyección
+  ~BinaryConfig();
+  BinaryConfig(const BinaryConfig&) = delete;
+  BinaryConfig& operator=(const BinaryConfig&) = delete;
+  // Getters de la clase
+  int getSize() const { return static_cast<int>(header_->size); }
+  BorderType getBorderType() const { return static_cast<BorderType>(header_->border); }
+  State getOpenState() const { return static_cast<State>(header_->open_state); }
+  int getRule() const { return static_cast<int>(header_->rule); }
+  // Células empaquetadas, (size + 7) / 8 bytes
+  const uint8_t* getCells() const { return cells_; }
+  // método que indica si un archivo está en formato binario (empieza por la firma)
+  static bool IsBinary(const std::string& file_name);
+
+ private:
+  void* mapping_ = nullptr; // dirección de la proyección
+  std::size_t length_ = 0; // bytes proyectados
+  const ConfigHeader* header_ = nullptr; // cabecera, al principio de la proyección
+  const uint8_t* cells_ = nullptr; // células, justo después de la cabecera
+};
+
+// Función que guarda una configuración en formato binario a partir de sus células empaquetadas
+void SaveBinaryConfig(const std::string& file_name, const int& size, const BorderType& borderType,
+                      const State& openState, const int& rule, const uint8_t* cells);
+
+#endif // BINARYCONFIG_H
\ No newline at end of file
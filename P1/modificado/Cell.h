@@ -44,7 +44,8 @@ enum StateValue { DEAD, ALIVE };
  * @brief La célula, Cell,es responsable de encapsular su estado binario y su posición dentro del
  * retículo unidimensional que representa al espacio celular. También es responsable de
  * conocer su vecindad y su función de transición
- * 
+ * Los estados de todas las células se guardan en el retículo, así que una célula es una vista
+ * ligera (posición y estado) que Lattice::getCell crea al consultarla.
  */
 class Cell {
  public:
@@ -54,22 +55,14 @@ class Cell {
   // de forma opcional su estado en la configuración inicial. Por defecto, la célula se
   // crea con estado «0».
   Cell(const Position&, const State&);
-  // Getters y setters de la clase
+  // Getters de la clase
   State getState() const { return state_; }
-  // método modificador para poder establecer la configuración inicial.
-  void setState(State);
-  // recibe el retículo por parámetro y calcula el siguiente estado sin evolucionar.
-  int NextState(const Lattice&);
-  // la evolución del autómata celular consiste en hacer que cada célula actualice su valor de estado.
-  void UpdateState();
-  // MODIFICACION --> REGLA 30
-  int Rule30(const Lattice& lattice);
+  Position getPosition() const { return position_; }
   // método que imprime el estado de la célula.
   friend std::ostream& operator<<(std::ostream&, const Cell&);
  private:
-  State state_; // estado de la célula
-  Position position_; // posición de la célula
-  State next_state_; // siguiente estado de la célula, siguiente generacion
+  State state_ = DEAD; // estado de la célula
+  Position position_ = 0; // posición de la célula
 };
 
 // Sobrecarga del operador de salida
@@ -0,0 +1,226 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file ColumnStream.cc
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Implementación de los métodos de la clase ColumnStream.
+ * Encontramos los constructores (desde un retículo y desde una ventana guardada), la consulta de una
+ * célula, el paso de una generación con el crecimiento de la ventana y el guardado de la ventana.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "ColumnStream.h"
+
+/**
+ * @brief Construct a new ColumnStream:: ColumnStream object
+ * La configuración inicial del retículo ocupa las células 0 a size - 1 de la línea y el resto es
+ * fondo muerto. La frontera del retículo no se usa, porque la línea es infinita. Por defecto se
+ * emite la columna central, la misma célula que empieza viva sin archivo de configuración inicial.
+ * @param lattice retículo empaquetado con la regla y la configuración inicial
+ */
+ColumnStream::ColumnStream(const PackedLattice& lattice) : rule_(lattice.getRule()) {
+  const long size = lattice.getSize();
+  current_.assign(WordOf(size - 1) + 1, 0);
+  next_.assign(current_.size(), 0);
+  lattice.PackRow(reinterpret_cast<uint8_t*>(current_.data()), false);
+  low_ = 0;
+  high_ = size - 1;
+  columns_.push_back(size / 2);
+  Trim();
+}
+
+/**
+ * @brief Construct a new ColumnStream:: ColumnStream object
+ * Lee la cabecera, las columnas y las palabras de la ventana que guardó Save. Si el archivo no es
+ * válido, se termina el programa.
+ * @param file_name nombre del archivo de la ventana
+ */
+ColumnStream::ColumnStream(const std::string& file_name) : rule_(30) {
+  std::ifstream input_file{file_name, std::ios::binary};
+  if (!input_file.is_open()) {
+    std::cerr << "File could not be opened." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  WindowHeader header;
+  input_file.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!input_file || std::memcmp(header.magic, kWindowMagic, sizeof(kWindowMagic)) != 0 ||
+      header.version != kWindowVersion || header.rule > 255 || header.low > header.high || header.background > 1) {
+    std::cerr << "The file " << file_name << " is not a valid window." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  rule_ = Rule(header.rule);
+  generation_ = header.generation;
+  low_ = header.low;
+  high_ = header.high;
+  background_ = header.background;
+  std::vector<int64_t> columns(header.columns);
+  input_file.read(reinterpret_cast<char*>(columns.data()), columns.size() * sizeof(int64_t));
+  columns_.assign(columns.begin(), columns.end());
+  base_ = WordOf(low_);
+  current_.assign(WordOf(high_) - base_ + 1, 0);
+  next_.assign(current_.size(), 0);
+  input_file.read(reinterpret_cast<char*>(current_.data()), current_.size() * sizeof(uint64_t));
+  if (!input_file) {
+    std::cerr << "The file " << file_name << " is not a valid window." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+/**
+ * @brief Método que devuelve el estado de una célula de la línea.
+ * @param cell célula, puede ser negativa o estar fuera de la configuración inicial
+ * @return State estado de la célula en la generación actual
+ */
+State ColumnStream::getState(const long& cell) const {
+  if (cell < low_ || cell > high_) {
+    return background_;
+  }
+  const long bit = cell - WordOf(cell) * 64;
+  return (current_[WordOf(cell) - base_] >> bit) & 1ULL;
+}
+
+/**
+ * @brief Método que evoluciona la ventana una generación.
+ * La ventana crece una célula por lado. Antes de calcular, las palabras que entran en la ventana y
+ * las dos de alrededor (que se leen como vecinas) se rellenan con el fondo de la generación actual.
+ * Después se calcula la nueva generación con la versión SIMD y la escalar, se intercambian los
+ * buffers, el fondo avanza según la regla y se recortan los extremos que han vuelto a ser fondo.
+ */
+void ColumnStream::NextGeneration() {
+  const long first = WordOf(low_ - 1), last = WordOf(high_ + 1);
+  Reserve(first - 1, last + 1);
+  for (long word = first - 1; word < WordOf(low_); ++word) {
+    current_[word - base_] = Background();
+  }
+  for (long word = WordOf(high_) + 1; word <= last + 1; ++word) {
+    current_[word - base_] = Background();
+  }
+  std::size_t begin = first - base_, population = 0;
+  const std::size_t end = last - base_ + 1;
+  if (simd_step_ != nullptr) {
+    begin = simd_step_(current_.data(), next_.data(), begin, end, rule_.getCode(), population);
+  }
+  switch (rule_.getCode()) {
+    case 30:
+      Step(RuleKernel<30>(), begin, end);
+      break;
+    case 90:
+      Step(RuleKernel<90>(), begin, end);
+      break;
+    case 110:
+      Step(RuleKernel<110>(), begin, end);
+      break;
+    case 184:
+      Step(RuleKernel<184>(), begin, end);
+      break;
+    default:
+      Step(TableKernel(rule_.getCode()), begin, end);
+      break;
+  }
+  current_.swap(next_);
+  --low_;
+  ++high_;
+  background_ = rule_.Apply(background_, background_, background_);
+  ++generation_;
+  Trim();
+}
+
+/**
+ * @brief Método que calcula palabras de la siguiente generación con el núcleo dado.
+ * Igual que en PackedLattice: los vecinos salen de desplazar un bit arrastrando el de la palabra contigua.
+ * @param kernel núcleo que aplica la regla a palabras completas
+ * @param begin primera palabra de los buffers
+ * @param end palabra siguiente a la última
+ */
+template <typename Kernel>
+void ColumnStream::Step(const Kernel& kernel, const std::size_t& begin, const std::size_t& end) {
+  const uint64_t* current = current_.data();
+  uint64_t* next = next_.data();
+  for (std::size_t k = begin; k < end; ++k) {
+    const uint64_t center = current[k];
+    const uint64_t left = (center << 1) | (current[k - 1] >> 63);
+    const uint64_t right = (center >> 1) | (current[k + 1] << 63);
+    next[k] = kernel(left, center, right);
+  }
+}
+
+/**
+ * @brief Método que amplía los buffers si las palabras [first, last] no caben.
+ * Se duplica el tamaño necesario y la ventana se vuelve a colocar en el centro, así que las
+ * ampliaciones son cada vez más raras aunque la ventana crezca en cada generación.
+ * @param first primera palabra que tiene que caber
+ * @param last última palabra que tiene que caber
+ */
+void ColumnStream::Reserve(const long& first, const long& last) {
+  if (first >= base_ && last - base_ < static_cast<long>(current_.size())) {
+    return;
+  }
+  const long needed = last - first + 1;
+  const long base = first - needed / 2;
+  std::vector<uint64_t> words(2 * needed, 0);
+  for (long word = WordOf(low_); word <= WordOf(high_); ++word) {
+    words[word - base] = current_[word - base_];
+  }
+  current_.swap(words);
+  next_.assign(current_.size(), 0);
+  base_ = base;
+}
+
+/**
+ * @brief Método que recorta la ventana.
+ * Desde cada extremo se saltan las palabras que son todo fondo y, en la primera que no lo es, las
+ * células del fondo hasta la primera distinta. Cada palabra se salta una sola vez, así que el coste
+ * se reparte entre las generaciones. Si toda la ventana es fondo, se queda en una sola célula.
+ */
+void ColumnStream::Trim() {
+  const uint64_t background = Background();
+  long first = WordOf(low_), last = WordOf(high_);
+  // Los bits de las palabras de los extremos que quedan fuera de la ventana ya son fondo
+  while (first <= last && current_[first - base_] == background) {
+    ++first;
+  }
+  if (first > last) {
+    low_ = high_ = WordOf(low_) * 64;
+    return;
+  }
+  while (current_[last - base_] == background) {
+    --last;
+  }
+  low_ = std::max(low_, first * 64 + __builtin_ctzll(current_[first - base_] ^ background));
+  high_ = std::min(high_, last * 64 + 63 - __builtin_clzll(current_[last - base_] ^ background));
+}
+
+/**
+ * @brief Método que guarda la ventana en un archivo.
+ * Se escribe la cabecera, las columnas y las palabras de low_ a high_, que es todo lo que hace falta
+ * para seguir el flujo en la generación actual.
+ * @param file_name nombre del archivo de salida
+ */
+void ColumnStream::Save(const std::string& file_name) const {
+  std::ofstream output_file{file_name, std::ios::binary};
+  if (!output_file.is_open()) {
+    std::cerr << "Unable to open file " << file_name << " for saving." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  WindowHeader header{};
+  std::memcpy(header.magic, kWindowMagic, sizeof(kWindowMagic));
+  header.version = kWindowVersion;
+  header.rule = rule_.getCode();
+  header.generation = generation_;
+  header.low = low_;
+  header.high = high_;
+  header.background = background_;
+  header.columns = columns_.size();
+  const std::vector<int64_t> columns(columns_.begin(), columns_.end());
+  output_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  output_file.write(reinterpret_cast<const char*>(columns.data()), columns.size() * sizeof(int64_t));
+  output_file.write(reinterpret_cast<const char*>(current_.data() + (WordOf(low_) - base_)),
+                    (WordOf(high_) - WordOf(low_) + 1) * sizeof(uint64_t));
+  if (!output_file) {
+    std::cerr << "Error writing the file " << file_name << "." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
\ No newline at end of file
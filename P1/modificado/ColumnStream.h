@@ -0,0 +1,101 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file ColumnStream.h
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Creación de la clase ColumnStream (generador del flujo de bits de una o varias columnas).
+ * La columna central de la regla 30 se usa como flujo de bits de prueba. Aquí la configuración inicial
+ * se coloca sobre una línea infinita con fondo muerto y solo se guarda una ventana empaquetada con las
+ * células que pueden ser distintas del fondo. Esa ventana crece como mucho una célula por lado y
+ * generación (el cono de luz), y deja fuera por los extremos lo que vuelve a ser fondo.
+ * La ventana se puede guardar en un archivo para continuar el flujo más tarde donde se dejó.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef COLUMNSTREAM_H
+#define COLUMNSTREAM_H
+
+#include "PackedLattice.h"
+#include "Rule.h"
+#include "RuleSimd.h"
+
+/**
+ * @brief Cabecera del archivo de la ventana, seguida de las columnas (int64) y de las palabras
+ */
+struct WindowHeader {
+  char magic[8]; // firma "AYEDACW1"
+  uint32_t version; // versión del formato, 1
+  uint32_t rule; // código de Wolfram de la regla
+  int64_t generation; // generación de la ventana
+  int64_t low; // primera célula que puede no ser del fondo
+  int64_t high; // última célula que puede no ser del fondo
+  uint32_t background; // estado de las células fuera de la ventana
+  uint32_t columns; // número de columnas
+};
+
+// Firma y versión del archivo de la ventana
+constexpr char kWindowMagic[8] = {'A', 'Y', 'E', 'D', 'A', 'C', 'W', '1'};
+constexpr uint32_t kWindowVersion = 1;
+
+/**
+ * @brief Clase Flujo de columnas
+ * La célula c está en el bit c % 64 de la palabra c / 64 (redondeando hacia abajo, también para las
+ * negativas). La palabra w se guarda en la posición w - base_ de los buffers, que se amplían y se
+ * vuelven a centrar cuando la ventana llega a un extremo. Las palabras de las células low_ a high_
+ * son siempre correctas; fuera de ellas todas las células tienen el estado del fondo.
+ */
+class ColumnStream {
+ public:
+  // Constructor que toma la regla y la configuración inicial de un retículo empaquetado
+  explicit ColumnStream(const PackedLattice& lattice);
+  // Constructor que continúa desde una ventana guardada
+  explicit ColumnStream(const std::string& file_name);
+  // Getters de la clase
+  const Rule& getRule() const { return rule_; }
+  long getGeneration() const { return generation_; }
+  // anchura de la ventana, en células
+  long getWidth() const { return high_ - low_ + 1; }
+  const std::vector<long>& getColumns() const { return columns_; }
+  // setter de las columnas que se emiten, relativas a la célula 0 de la configuración inicial
+  void setColumns(const std::vector<long>& columns) { columns_ = columns; }
+  // setter del nivel SIMD con el que se calcula cada generación
+  void setSimdLevel(const SimdLevel& level) { simd_step_ = GetSimdStep(level); }
+  // método que devuelve el estado de cualquier célula de la línea en la generación actual
+  State getState(const long& cell) const;
+  // método que evoluciona la ventana una generación
+  void NextGeneration();
+  // método que guarda la ventana para continuar más tarde
+  void Save(const std::string& file_name) const;
+
+ private:
+  // método que devuelve la palabra que contiene una célula
+  static long WordOf(const long& cell) { return cell >= 0 ? cell / 64 : -((63 - cell) / 64); }
+  // método que devuelve una palabra con todas las células en el estado del fondo
+  uint64_t Background() const { return background_ ? ~0ULL : 0ULL; }
+  // método que amplía los buffers para que quepan las palabras [first, last]
+  void Reserve(const long& first, const long& last);
+  // método que deja fuera de la ventana las células de los extremos que son del fondo
+  void Trim();
+  // método que calcula las palabras [begin, end) de los buffers con el núcleo de la regla
+  template <typename Kernel>
+  void Step(const Kernel& kernel, const std::size_t& begin, const std::size_t& end);
+  std::vector<uint64_t> current_; // generación actual
+  std::vector<uint64_t> next_; // siguiente generación
+  long base_ = 0; // palabra que está en la posición 0 de los buffers
+  long low_ = 0; // primera célula que puede no ser del fondo
+  long high_ = 0; // última célula que puede no ser del fondo
+  State background_ = DEAD; // estado de las células fuera de la ventana
+  long generation_ = 0; // generación actual
+  Rule rule_; // regla que se aplica
+  std::vector<long> columns_; // columnas que se emiten
+  SimdStepFunction simd_step_ = GetSimdStep(AUTO); // paso vectorial, nullptr si es escalar
+};
+
+#endif // COLUMNSTREAM_H
\ No newline at end of file
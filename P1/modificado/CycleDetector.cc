@@ -0,0 +1,69 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file CycleDetector.cc
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Implementación de la función HashWords y de los métodos de la clase CycleDetector.
+ */
+
+#include "CycleDetector.h"
+
+/**
+ * @brief Función que calcula la parte del hash de 128 bits de un trozo de un estado empaquetado.
+ * Cada palabra aporta a cada mitad del hash la mezcla de la palabra con una clave que depende de su
+ * posición k en el estado, con claves distintas en cada mitad. El hash del estado es la suma de las
+ * aportaciones de todas sus palabras, así que da igual cómo se parta en trozos. Las aportaciones de
+ * palabras seguidas no dependen unas de otras, así que sus multiplicaciones se solapan en el procesador.
+ * @param words palabras del trozo
+ * @param count número de palabras
+ * @param first posición en el estado de la primera palabra del trozo
+ * @return StateHash parte del hash del estado
+ */
+StateHash HashWords(const uint64_t* words, const std::size_t& count, const std::size_t& first) {
+  StateHash hash{0, 0};
+  for (std::size_t k = 0; k < count; ++k) {
+    const uint64_t position = first + k;
+    hash.low += Mix64(words[k] ^ (0x243f6a8885a308d3ULL + position * 0x9e3779b97f4a7c15ULL));
+    hash.high += Mix64((words[k] + (0x13198a2e03707344ULL + position * 0xc2b2ae3d27d4eb4fULL)) * 0xff51afd7ed558ccdULL);
+  }
+  return hash;
+}
+
+/**
+ * @brief Método que olvida todas las generaciones guardadas y el ciclo detectado
+ */
+void CycleDetector::Reset() {
+  history_.clear();
+  transient_ = -1;
+  period_ = -1;
+  exhausted_ = false;
+}
+
+/**
+ * @brief Método que guarda el hash de una generación.
+ * Si el hash ya estaba, el estado se repite: el transitorio es la generación en la que apareció por
+ * primera vez y el periodo la distancia hasta esta. Una vez detectado el ciclo no se guarda nada más.
+ * Si la tabla llega a kMaxHistory generaciones, se vacía y se deja de buscar.
+ * @param hash hash del estado
+ * @param generation generación del estado
+ * @return true si con esta generación se detecta el ciclo
+ */
+bool CycleDetector::Record(const StateHash& hash, const long& generation) {
+  if (!Searching()) {
+    return false;
+  }
+  const auto inserted = history_.emplace(hash, generation);
+  if (inserted.second) {
+    if (history_.size() >= kMaxHistory) {
+      history_.clear();
+      exhausted_ = true;
+    }
+    return false;
+  }
+  transient_ = inserted.first->second;
+  period_ = generation - transient_;
+  // El historial ya no hace falta
+  history_.clear();
+  return true;
+}
\ No newline at end of file
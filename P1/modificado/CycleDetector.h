@@ -0,0 +1,89 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file CycleDetector.h
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Creación de la clase CycleDetector y de la función de hash de 128 bits del estado.
+ * Un retículo finito tiene un número finito de estados y la evolución es determinista, así que tarde
+ * o temprano repite un estado y a partir de ahí se repite todo. Si el estado de la generación g es
+ * igual al de una generación anterior m, el transitorio dura m generaciones y el periodo es g - m.
+ * En vez de guardar los estados se guarda un hash de 128 bits de cada uno, indexado en una tabla:
+ * la probabilidad de que dos estados distintos coincidan es despreciable.
+ * El hash es la suma de un término por palabra que depende de la palabra y de su posición, así que se
+ * puede calcular por trozos (por ejemplo, uno por hilo) y sumar las partes.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#ifndef CYCLEDETECTOR_H
+#define CYCLEDETECTOR_H
+
+/**
+ * @brief Hash de 128 bits de un estado
+ */
+struct StateHash {
+  uint64_t low;
+  uint64_t high;
+  bool operator==(const StateHash& other) const { return low == other.low && high == other.high; }
+  // suma la parte del hash de otro trozo del estado
+  StateHash& operator+=(const StateHash& other) {
+    low += other.low;
+    high += other.high;
+    return *this;
+  }
+};
+
+/**
+ * @brief Función de hash para usar StateHash como clave (sus bits ya están mezclados)
+ */
+struct StateHashHasher {
+  std::size_t operator()(const StateHash& hash) const { return hash.low; }
+};
+
+/**
+ * @brief Mezcla final de 64 bits de splitmix64, para que cada bit dependa de todos los demás.
+ * La usan el hash de los estados y los generadores pseudoaleatorios.
+ */
+inline uint64_t Mix64(uint64_t value) {
+  value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+  return value ^ (value >> 31);
+}
+
+// Función que calcula la parte del hash de 128 bits de las palabras first a first + count - 1 de un estado
+StateHash HashWords(const uint64_t* words, const std::size_t& count, const std::size_t& first = 0);
+
+/**
+ * @brief Clase Detector de ciclos
+ * Se le pasa el hash de cada generación. Cuando uno se repite, guarda el transitorio y el periodo
+ * y deja de guardar hashes.
+ * Cada generación guardada ocupa unos 64 bytes en la tabla, así que se guardan como mucho kMaxHistory
+ * (unos 256 MiB). Si se llega al límite sin encontrar el ciclo, se deja de buscar.
+ */
+class CycleDetector {
+ public:
+  // Número máximo de generaciones guardadas
+  static constexpr std::size_t kMaxHistory = std::size_t{1} << 22;
+  // método que olvida todas las generaciones guardadas
+  void Reset();
+  // método que guarda el hash de una generación; devuelve true si con ella se detecta el ciclo
+  bool Record(const StateHash& hash, const long& generation);
+  // Getters de la clase
+  bool Found() const { return period_ > 0; }
+  bool Exhausted() const { return exhausted_; }
+  // si todavía hace falta el hash de cada generación
+  bool Searching() const { return !Found() && !exhausted_; }
+  long getTransient() const { return transient_; }
+  long getPeriod() const { return period_; }
+
+ private:
+  std::unordered_map<StateHash, long, StateHashHasher> history_; // generación de cada hash
+  long transient_ = -1; // generaciones antes de entrar en el ciclo, -1 si no se ha detectado
+  long period_ = -1; // longitud del ciclo (1 si es un punto fijo), -1 si no se ha detectado
+  bool exhausted_ = false; // si se llegó a kMaxHistory generaciones sin detectar el ciclo
+};
+
+#endif // CYCLEDETECTOR_H
\ No newline at end of file
@@ -0,0 +1,236 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file EnsembleLattice.cc
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Implementación de los métodos de la clase EnsembleLattice.
+ * Encontramos los constructores (aleatorio y desde archivo), la colocación de las células frontera,
+ * el paso de una generación y el cálculo de la población de cada simulación.
+ */
+
+#include "EnsembleLattice.h"
+
+/**
+ * @brief Generador pseudoaleatorio splitmix64: devuelve un número y avanza el estado
+ */
+static uint64_t SplitMix64(uint64_t& state) {
+  return Mix64(state += 0x9e3779b97f4a7c15ULL);
+}
+
+/**
+ * @brief Traspone una matriz de 64 x 64 bits: después, el bit c de la fila r es el bit r de la fila c.
+ * Se intercambian bloques cada vez más pequeños (32, 16, ..., 1 bits) con máscaras, en 6 pasadas.
+ */
+static void Transpose64(uint64_t* rows) {
+  uint64_t mask = 0x00000000ffffffffULL;
+  for (int j = 32; j != 0; j >>= 1, mask ^= mask << j) {
+    for (int k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+      const uint64_t swap = ((rows[k] >> j) ^ rows[k | j]) & mask;
+      rows[k] ^= swap << j;
+      rows[k | j] ^= swap;
+    }
+  }
+}
+
+/**
+ * @brief Constructor con configuraciones iniciales aleatorias.
+ * Cada palabra es un número aleatorio, así que cada célula de cada simulación está viva con
+ * probabilidad 1/2 independientemente del resto. La misma semilla da siempre las mismas simulaciones.
+ * @param size número de células de cada simulación
+ * @param borderType tipo de frontera
+ * @param openState estado de las células frontera si la frontera es abierta
+ * @param rule código de Wolfram de la regla que se aplica
+ * @param simulations número de simulaciones
+ * @param seed semilla del generador
+ */
+EnsembleLattice::EnsembleLattice(const int& size, const BorderType& borderType, const State& openState,
+                                 const int& rule, const std::size_t& simulations, const uint64_t& seed)
+    : size_(size), simulations_(simulations), borderType_(borderType), openState_(openState), rule_(rule) {
+  Allocate();
+  uint64_t state = seed;
+  for (std::size_t k = lanes_; k < (size_ + 1) * lanes_; ++k) {
+    current_[k] = SplitMix64(state);
+  }
+  // Las simulaciones que sobran de la última palabra empiezan muertas
+  if (simulations_ % 64 != 0) {
+    for (int i = 0; i < size_; ++i) {
+      current_[(i + 2) * lanes_ - 1] &= (1ULL << (simulations_ % 64)) - 1;
+    }
+  }
+}
+
+/**
+ * @brief Constructor que lee las configuraciones iniciales desde un archivo.
+ * Cada línea no vacía es una simulación con el mismo formato que configuracion_inicial.txt:
+ * un 0 o un 1 por célula separados por espacios. Si alguna línea no tiene size células, se termina.
+ * @param size número de células de cada simulación
+ * @param borderType tipo de frontera
+ * @param openState estado de las células frontera si la frontera es abierta
+ * @param rule código de Wolfram de la regla que se aplica
+ * @param file_name nombre del archivo con las configuraciones iniciales
+ */
+EnsembleLattice::EnsembleLattice(const int& size, const BorderType& borderType, const State& openState,
+                                 const int& rule, const std::string& file_name)
+    : size_(size), simulations_(0), borderType_(borderType), openState_(openState), rule_(rule) {
+  std::ifstream input_file{file_name};
+  // verifica si el archivo se abrió correctamente
+  if (!input_file.is_open()) {
+    std::cerr << "File could not be opened." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  // Primero se leen todas las configuraciones, ya que hace falta saber cuántas hay para reservar
+  std::vector<std::vector<bool>> configurations;
+  std::string line;
+  while (std::getline(input_file, line)) {
+    std::istringstream values{line};
+    std::vector<bool> configuration;
+    int state;
+    while (values >> state) {
+      configuration.push_back(state != 0);
+    }
+    if (configuration.empty()) {
+      continue;
+    }
+    if (configuration.size() != static_cast<std::size_t>(size_)) {
+      std::cerr << "Size specified in option \"-size\" does not match with the number of states in line "
+                << configurations.size() + 1 << " of the file " << file_name << "." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    configurations.push_back(configuration);
+  }
+  if (configurations.empty()) {
+    std::cerr << "The file " << file_name << " has no configurations." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  simulations_ = configurations.size();
+  Allocate();
+  for (std::size_t simulation = 0; simulation < simulations_; ++simulation) {
+    const uint64_t bit = 1ULL << (simulation % 64);
+    for (int i = 0; i < size_; ++i) {
+      if (configurations[simulation][i]) {
+        current_[(i + 1) * lanes_ + simulation / 64] |= bit;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Método que reserva las palabras de las dos generaciones, con las filas de la frontera
+ */
+void EnsembleLattice::Allocate() {
+  lanes_ = (simulations_ + 63) / 64;
+  current_.assign((size_ + 2) * lanes_, 0);
+  next_.assign((size_ + 2) * lanes_, 0);
+}
+
+/**
+ * @brief Método que devuelve el estado de una célula de una simulación
+ * @param simulation número de simulación
+ * @param position posición de la célula, entre 0 y size - 1
+ * @return State estado de la célula
+ */
+State EnsembleLattice::getState(const std::size_t& simulation, const Position& position) const {
+  return (current_[(position + 1) * lanes_ + simulation / 64] >> (simulation % 64)) & 1ULL;
+}
+
+/**
+ * @brief Método que coloca las células frontera de todas las simulaciones a la vez.
+ * Igual que en PackedLattice, pero copiando filas completas de palabras.
+ */
+void EnsembleLattice::UpdateBorders() {
+  uint64_t* left = current_.data();
+  uint64_t* right = current_.data() + (size_ + 1) * lanes_;
+  for (std::size_t lane = 0; lane < lanes_; ++lane) {
+    if (borderType_ == PERIODIC) {
+      left[lane] = current_[size_ * lanes_ + lane];
+      right[lane] = current_[lanes_ + lane];
+    } else if (borderType_ == REFLECTIVE) {
+      left[lane] = current_[lanes_ + lane];
+      right[lane] = current_[size_ * lanes_ + lane];
+    } else {
+      left[lane] = right[lane] = openState_ ? ~0ULL : 0ULL;
+    }
+  }
+}
+
+/**
+ * @brief Función que evoluciona todas las simulaciones una generación.
+ * Primero se calcula con la versión SIMD lo que cabe en vectores completos y el resto con la versión
+ * escalar, con el núcleo especializado de la regla si lo tiene.
+ */
+void EnsembleLattice::NextGeneration() {
+  UpdateBorders();
+  std::size_t begin = lanes_;
+  if (simd_step_ != nullptr) {
+    begin = simd_step_(current_.data(), next_.data(), begin, (size_ + 1) * lanes_, lanes_, rule_.getCode());
+  }
+  switch (rule_.getCode()) {
+    case 30:
+      Step(RuleKernel<30>(), begin);
+      break;
+    case 90:
+      Step(RuleKernel<90>(), begin);
+      break;
+    case 110:
+      Step(RuleKernel<110>(), begin);
+      break;
+    case 184:
+      Step(RuleKernel<184>(), begin);
+      break;
+    default:
+      Step(TableKernel(rule_.getCode()), begin);
+      break;
+  }
+  current_.swap(next_);
+}
+
+/**
+ * @brief Función que evoluciona todas las simulaciones varias generaciones
+ * @param generations número de generaciones
+ */
+void EnsembleLattice::Evolve(const long& generations) {
+  for (long generation = 0; generation < generations; ++generation) {
+    NextGeneration();
+  }
+}
+
+/**
+ * @brief Método que calcula palabras de la siguiente generación con el núcleo dado.
+ * Las vecinas izquierda y derecha de cada palabra son las de la célula anterior y la siguiente.
+ * @param kernel núcleo que aplica la regla a palabras completas
+ * @param begin primera palabra; se calcula hasta el final de la última célula
+ */
+template <typename Kernel>
+void EnsembleLattice::Step(const Kernel& kernel, const std::size_t& begin) {
+  const uint64_t* current = current_.data();
+  uint64_t* next = next_.data();
+  for (std::size_t k = begin; k < (size_ + 1) * lanes_; ++k) {
+    next[k] = kernel(current[k - lanes_], current[k], current[k + lanes_]);
+  }
+}
+
+/**
+ * @brief Método que devuelve el número de células vivas de cada simulación.
+ * Las células se toman de 64 en 64: las 64 palabras de una misma lane forman una matriz de 64 x 64
+ * bits con una célula por fila y una simulación por columna. Al trasponerla, cada fila tiene las
+ * 64 células de una simulación y basta con contar sus bits a 1.
+ * @return std::vector<std::size_t> población de cada simulación
+ */
+std::vector<std::size_t> EnsembleLattice::Populations() const {
+  std::vector<std::size_t> populations(lanes_ * 64, 0);
+  uint64_t block[64];
+  for (std::size_t lane = 0; lane < lanes_; ++lane) {
+    for (int first = 0; first < size_; first += 64) {
+      for (int row = 0; row < 64; ++row) {
+        block[row] = first + row < size_ ? current_[(first + row + 1) * lanes_ + lane] : 0;
+      }
+      Transpose64(block);
+      for (int column = 0; column < 64; ++column) {
+        populations[lane * 64 + column] += __builtin_popcountll(block[column]);
+      }
+    }
+  }
+  populations.resize(simulations_);
+  return populations;
+}
\ No newline at end of file
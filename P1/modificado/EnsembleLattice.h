@@ -0,0 +1,77 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file EnsembleLattice.h
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Creación de la clase EnsembleLattice (conjunto de simulaciones en paralelo por bits).
+ * Evoluciona a la vez muchas simulaciones del mismo tamaño, regla y frontera, cada una con su propia
+ * configuración inicial. El bit j de cada palabra pertenece a la simulación j, así que una sola
+ * operación lógica sobre una palabra avanza la misma célula de 64 simulaciones, y con las versiones
+ * SIMD de 128 a 512 simulaciones por instrucción.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef ENSEMBLELATTICE_H
+#define ENSEMBLELATTICE_H
+
+#include "Lattice.h"
+#include "Rule.h"
+#include "RuleSimd.h"
+
+/**
+ * @brief Clase Conjunto de retículos
+ * Las simulaciones se agrupan de 64 en 64 en palabras (lanes). La célula i de todas las simulaciones
+ * ocupa las palabras [(i + 1) * lanes, (i + 2) * lanes): las filas 0 y size + 1 son las células
+ * frontera. Así las vecinas de una palabra están lanes posiciones antes y después.
+ */
+class EnsembleLattice {
+ public:
+  // Constructor con configuraciones iniciales aleatorias (cada célula viva con probabilidad 1/2)
+  EnsembleLattice(const int& size, const BorderType& borderType, const State& openState, const int& rule,
+                  const std::size_t& simulations, const uint64_t& seed);
+  // Constructor que lee una configuración inicial por línea desde un archivo
+  EnsembleLattice(const int& size, const BorderType& borderType, const State& openState, const int& rule,
+                  const std::string& file_name);
+  // Getters de la clase
+  int getSize() const { return size_; }
+  std::size_t getSimulations() const { return simulations_; }
+  const Rule& getRule() const { return rule_; }
+  // setter del nivel SIMD con el que se calcula cada generación
+  void setSimdLevel(const SimdLevel& level) { simd_step_ = GetSimdEnsemble(level); }
+  // método que devuelve el estado de una célula de una simulación
+  State getState(const std::size_t& simulation, const Position& position) const;
+  // método que evoluciona todas las simulaciones una generación
+  void NextGeneration();
+  // método que evoluciona todas las simulaciones varias generaciones
+  void Evolve(const long&);
+  // método que devuelve el número de células vivas de cada simulación
+  std::vector<std::size_t> Populations() const;
+
+ private:
+  // método que reserva las palabras según el número de simulaciones
+  void Allocate();
+  // método que coloca las células frontera de todas las simulaciones
+  void UpdateBorders();
+  // método que calcula las palabras [begin, end) con el núcleo de la regla
+  template <typename Kernel>
+  void Step(const Kernel& kernel, const std::size_t& begin);
+  std::vector<uint64_t> current_; // generación actual
+  std::vector<uint64_t> next_; // siguiente generación
+  int size_; // número de células de cada simulación (sin contar la frontera)
+  std::size_t simulations_; // número de simulaciones
+  std::size_t lanes_; // palabras por célula, simulations / 64 redondeado hacia arriba
+  BorderType borderType_; // tipo de frontera
+  State openState_; // estado de las células frontera si es abierta
+  Rule rule_; // regla que se aplica
+  SimdEnsembleFunction simd_step_ = GetSimdEnsemble(AUTO); // paso vectorial, nullptr si es escalar
+};
+
+#endif // ENSEMBLELATTICE_H
\ No newline at end of file
@@ -0,0 +1,152 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file History.cc
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Implementación de los métodos de la clase History.
+ * Encontramos la búsqueda de fotogramas, su codificación como diferencia comprimida y su
+ * reconstrucción, y el descarte de fotogramas cuando se pasa del presupuesto de memoria.
+ */
+
+#include "History.h"
+
+/**
+ * @brief Construct a new History:: History object
+ * @param cells número de células del retículo, sin la frontera
+ * @param budget presupuesto de memoria de los fotogramas, en bytes
+ * @param interval generaciones entre fotogramas al empezar (K)
+ * @param delta si se guardan los fotogramas como diferencia comprimida con el anterior
+ */
+History::History(const int& cells, const std::size_t& budget, const long& interval, const bool& delta)
+    : words_((static_cast<std::size_t>(cells) + 63) / 64), budget_(budget), interval_(interval), delta_(delta) {}
+
+/**
+ * @brief Método que busca el último fotograma con generación menor o igual que la dada.
+ * El primer fotograma es la generación en la que empieza el historial, que nunca se descarta.
+ * @param generation generación
+ * @return std::size_t posición del fotograma
+ */
+std::size_t History::Find(const long& generation) const {
+  const auto after = std::upper_bound(keyframes_.begin(), keyframes_.end(), generation,
+                                      [](const long& value, const Keyframe& keyframe) { return value < keyframe.generation; });
+  return after == keyframes_.begin() ? 0 : after - keyframes_.begin() - 1;
+}
+
+/**
+ * @brief Método que añade un fotograma.
+ * Mientras los fotogramas ocupen más que el presupuesto (y quede más de uno), se duplica K.
+ * @param generation generación del fotograma
+ * @param state estado completo
+ */
+void History::Add(const long& generation, const std::vector<uint64_t>& state) {
+  Append(generation, state);
+  while (bytes_ > budget_ && keyframes_.size() > 1) {
+    Thin();
+  }
+}
+
+/**
+ * @brief Método que añade un fotograma al final.
+ * Es completo si no se guardan diferencias, si es el primero o si ya van kFullEvery - 1 diferencias
+ * seguidas; si no, se guarda la diferencia con el último fotograma comprimida.
+ * @param generation generación del fotograma
+ * @param state estado completo
+ */
+void History::Append(const long& generation, const std::vector<uint64_t>& state) {
+  Keyframe keyframe{generation, !delta_ || keyframes_.empty() || since_full_ + 1 >= kFullEvery, {}};
+  if (keyframe.full) {
+    keyframe.data = state;
+    since_full_ = 0;
+  } else {
+    std::vector<uint64_t> difference(words_);
+    for (std::size_t k = 0; k < words_; ++k) {
+      difference[k] = state[k] ^ last_[k];
+    }
+    Encode(difference, keyframe.data);
+    ++since_full_;
+  }
+  bytes_ += keyframe.data.size() * sizeof(uint64_t);
+  keyframes_.push_back(std::move(keyframe));
+  last_ = state;
+}
+
+/**
+ * @brief Método que descarta la mitad de los fotogramas.
+ * Se duplica K y se recorren los fotogramas en orden reconstruyendo cada estado; los que siguen
+ * siendo múltiplo de K se vuelven a añadir, con las diferencias calculadas respecto a los que quedan.
+ */
+void History::Thin() {
+  interval_ *= 2;
+  std::vector<Keyframe> keyframes;
+  keyframes.swap(keyframes_);
+  bytes_ = 0;
+  since_full_ = 0;
+  std::vector<uint64_t> state(words_, 0);
+  for (const Keyframe& keyframe : keyframes) {
+    if (keyframe.full) {
+      state = keyframe.data;
+    } else {
+      ApplyDifference(keyframe.data, state);
+    }
+    if (keyframe.generation % interval_ == 0 || keyframes_.empty()) {
+      Append(keyframe.generation, state);
+    }
+  }
+}
+
+/**
+ * @brief Método que reconstruye el estado de un fotograma.
+ * Se parte del último fotograma completo anterior y se aplican las diferencias hasta él.
+ * @param index posición del fotograma
+ * @return std::vector<uint64_t> estado completo
+ */
+std::vector<uint64_t> History::Decode(const std::size_t& index) const {
+  std::size_t first = index;
+  while (!keyframes_[first].full) {
+    --first;
+  }
+  std::vector<uint64_t> state = keyframes_[first].data;
+  for (std::size_t k = first + 1; k <= index; ++k) {
+    ApplyDifference(keyframes_[k].data, state);
+  }
+  return state;
+}
+
+/**
+ * @brief Método que comprime una diferencia por rachas.
+ * Cada bloque salta las palabras a 0 seguidas y copia las distintas de 0 que vienen detrás.
+ * @param difference diferencia sin comprimir
+ * @param data diferencia comprimida
+ */
+void History::Encode(const std::vector<uint64_t>& difference, std::vector<uint64_t>& data) {
+  std::size_t k = 0;
+  while (k < difference.size()) {
+    const std::size_t zeros_begin = k;
+    while (k < difference.size() && difference[k] == 0) {
+      ++k;
+    }
+    const std::size_t literals_begin = k;
+    while (k < difference.size() && difference[k] != 0) {
+      ++k;
+    }
+    data.push_back(static_cast<uint64_t>(literals_begin - zeros_begin) << 32 | (k - literals_begin));
+    data.insert(data.end(), difference.begin() + literals_begin, difference.begin() + k);
+  }
+}
+
+/**
+ * @brief Método que aplica una diferencia comprimida a un estado
+ * @param data diferencia comprimida
+ * @param state estado al que se aplica
+ */
+void History::ApplyDifference(const std::vector<uint64_t>& data, std::vector<uint64_t>& state) {
+  std::size_t k = 0, i = 0;
+  while (i < data.size()) {
+    const uint64_t header = data[i++];
+    k += header >> 32;
+    for (uint64_t literals = header & 0xffffffffULL; literals > 0; --literals) {
+      state[k++] ^= data[i++];
+    }
+  }
+}
\ No newline at end of file
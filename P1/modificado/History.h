@@ -0,0 +1,156 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file History.h
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Creación de la clase History (historial de fotogramas clave de la evolución).
+ * Guarda el retículo empaquetado cada K generaciones. Para volver a cualquier generación se carga el
+ * fotograma clave anterior más cercano y se evoluciona desde él, como mucho K - 1 generaciones, en
+ * vez de repetir la evolución desde la generación 0.
+ * Los fotogramas se pueden guardar como diferencia (XOR) con el anterior comprimida por rachas (RLE):
+ * en las zonas que no cambian la diferencia son palabras a 0 y ocupan casi nada. Si el historial
+ * pasa del presupuesto de memoria, se duplica K y se descartan los fotogramas que sobran.
+ * Sirve tanto para Lattice como para PackedLattice, que tienen PackRow, LoadRow y Evolve.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+/**
+ * @brief Clase Historial
+ * Cada fotograma guarda su generación y sus datos: el estado completo (una palabra por cada 64
+ * células, como en PackRow) o la diferencia comprimida con el fotograma anterior. Uno de cada
+ * kFullEvery es completo, así que para reconstruir uno basta con aplicar pocas diferencias.
+ * La diferencia comprimida es una serie de bloques: una palabra de cabecera con el número de
+ * palabras a 0 que se saltan (32 bits altos) y el número de palabras distintas de 0 que siguen
+ * (32 bits bajos), y después esas palabras.
+ */
+class History {
+ public:
+  // Constructor que recibe las células, el presupuesto en bytes, K y si se guardan diferencias
+  History(const int& cells, const std::size_t& budget, const long& interval, const bool& delta);
+  // Getters de la clase
+  long getInterval() const { return interval_; }
+  std::size_t getKeyframes() const { return keyframes_.size(); }
+  std::size_t getBytes() const { return bytes_; }
+  // método que guarda la generación actual si le toca ser fotograma clave
+  template <typename LatticeType>
+  void Record(const LatticeType& lattice);
+  // método que evoluciona el retículo guardando los fotogramas clave por los que pasa
+  template <typename LatticeType>
+  void Advance(LatticeType& lattice, long generations);
+  // método que lleva el retículo a una generación desde el fotograma clave anterior más cercano
+  template <typename LatticeType>
+  void Restore(LatticeType& lattice, const long& generation) const;
+  // método que lleva el retículo a cualquier generación por el camino más corto
+  template <typename LatticeType>
+  void Seek(LatticeType& lattice, const long& generation);
+
+ private:
+  // Cada cuántos fotogramas se guarda uno completo
+  static constexpr std::size_t kFullEvery = 16;
+  /**
+   * @brief Fotograma clave
+   */
+  struct Keyframe {
+    long generation; // generación del fotograma
+    bool full; // si los datos son el estado completo o la diferencia comprimida
+    std::vector<uint64_t> data; // datos del fotograma
+  };
+  // método que devuelve la posición del último fotograma con generación menor o igual que la dada
+  std::size_t Find(const long& generation) const;
+  // método que añade un fotograma y, si se pasa del presupuesto, descarta la mitad
+  void Add(const long& generation, const std::vector<uint64_t>& state);
+  // método que añade un fotograma al final, completo o como diferencia con el último
+  void Append(const long& generation, const std::vector<uint64_t>& state);
+  // método que duplica K y vuelve a codificar los fotogramas que quedan
+  void Thin();
+  // método que reconstruye el estado de un fotograma
+  std::vector<uint64_t> Decode(const std::size_t& index) const;
+  // método que comprime una diferencia por rachas de palabras a 0
+  static void Encode(const std::vector<uint64_t>& difference, std::vector<uint64_t>& data);
+  // método que aplica una diferencia comprimida a un estado
+  static void ApplyDifference(const std::vector<uint64_t>& data, std::vector<uint64_t>& state);
+  std::size_t words_; // palabras de cada estado
+  std::size_t budget_; // presupuesto de memoria en bytes
+  long interval_; // generaciones entre fotogramas (K)
+  bool delta_; // si se guardan diferencias comprimidas
+  std::vector<Keyframe> keyframes_; // fotogramas, ordenados por generación
+  std::vector<uint64_t> last_; // estado del último fotograma, con el que se calcula la siguiente diferencia
+  std::size_t since_full_ = 0; // fotogramas guardados como diferencia desde el último completo
+  std::size_t bytes_ = 0; // bytes que ocupan los datos de los fotogramas
+};
+
+/**
+ * @brief Método que guarda la generación actual del retículo si es múltiplo de K y posterior al
+ * último fotograma (al volver atrás y avanzar otra vez no se repiten fotogramas).
+ * @param lattice retículo
+ */
+template <typename LatticeType>
+void History::Record(const LatticeType& lattice) {
+  const long generation = lattice.getGeneration();
+  if (generation % interval_ != 0 || (!keyframes_.empty() && generation <= keyframes_.back().generation)) {
+    return;
+  }
+  std::vector<uint64_t> state(words_, 0);
+  lattice.PackRow(reinterpret_cast<uint8_t*>(state.data()), false);
+  Add(generation, state);
+}
+
+/**
+ * @brief Método que evoluciona el retículo guardando los fotogramas clave.
+ * Se evoluciona a trozos que terminan en los múltiplos de K, así que el retículo sigue avanzando
+ * varias generaciones de una vez (con sus hilos o su bloqueo temporal).
+ * @param lattice retículo
+ * @param generations número de generaciones
+ */
+template <typename LatticeType>
+void History::Advance(LatticeType& lattice, long generations) {
+  Record(lattice);
+  while (generations > 0) {
+    const long step = std::min(generations, interval_ - lattice.getGeneration() % interval_);
+    lattice.Evolve(step);
+    generations -= step;
+    Record(lattice);
+  }
+}
+
+/**
+ * @brief Método que lleva el retículo a una generación.
+ * Se reconstruye el fotograma clave anterior más cercano, se carga en el retículo y se evoluciona
+ * lo que falta. No se guardan fotogramas nuevos.
+ * @param lattice retículo
+ * @param generation generación, mayor o igual que 0
+ */
+template <typename LatticeType>
+void History::Restore(LatticeType& lattice, const long& generation) const {
+  const std::size_t index = Find(generation);
+  const std::vector<uint64_t> state = Decode(index);
+  lattice.LoadRow(reinterpret_cast<const uint8_t*>(state.data()), keyframes_[index].generation);
+  lattice.Evolve(generation - keyframes_[index].generation);
+}
+
+/**
+ * @brief Método que lleva el retículo a cualquier generación.
+ * Si es anterior a la actual, o hay un fotograma clave entre la actual y la pedida, se parte del
+ * fotograma; si no, se sigue evolucionando desde la actual. Lo que pase del último fotograma se
+ * evoluciona con Advance, así que se siguen guardando fotogramas.
+ * @param lattice retículo
+ * @param generation generación, mayor o igual que 0
+ */
+template <typename LatticeType>
+void History::Seek(LatticeType& lattice, const long& generation) {
+  if (generation < lattice.getGeneration() || keyframes_[Find(generation)].generation > lattice.getGeneration()) {
+    Restore(lattice, std::min(generation, keyframes_.back().generation));
+  }
+  Advance(lattice, generation - lattice.getGeneration());
+}
+
+#endif // HISTORY_H
\ No newline at end of file
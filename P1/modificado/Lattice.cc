@@ -12,6 +12,7 @@
 */
 
 #include "Lattice.h"
+#include "BinaryConfig.h"
 
 /**
  * @brief Constructor que se encarga de inicializar el retículo cuando no hay archivo de configuración inicial.
@@ -21,41 +22,24 @@
  * Si el tipo de frontera es frío, no se hace nada.
  * @param size tamaño que se le asigna al retículo por linea de comandos
  * @param borderType Tipo de frontera que se le asigna al retículo por linea de comandos
+ * @param openState estado de las células frontera si la frontera es abierta
  */
-Lattice::Lattice(const int& size, const BorderType& borderType, char* argv[]) {
+Lattice::Lattice(const int& size, const BorderType& borderType, const State& openState) {
   // Se ajusta el tamaño del retículo para incluir bordes.
   size_ = size + 2;
-  cells_.resize(size_);
-  State state;
-  // Se itera sobre todas las células en el retículo.
-  for (int i = 0; i < size_; ++i) {
-    // Verificar el tipo de frontera
-    // Se establecen las células en los bordes en estado de vida (ALIVE).
-    if (i == size_ / 2) {
-      state = ALIVE;
-    } else {
-      state = DEAD;
-    } 
-    // Crear la nueva célula con el estado determinado y agregarla al vector de células.
-    cells_[i] = new Cell(i, state);
-  }
+  borderType_ = borderType;
+  // Todas las células empiezan muertas salvo la central
+  current_.assign(size_, DEAD);
+  current_[size_ / 2] = ALIVE;
+  population_ = 1;
   // si es abierta
   if (borderType == OPEN) {
-    if (atoi(argv[5]) == 0  || atoi(argv[5]) == 1) {
-      cells_[0] = new Cell(0, (State)atoi(argv[5]));
-      cells_[size_ - 1] = new Cell(size_ - 1, (State)atoi(argv[5]));
-    } else {
-      std::cout << "Error, valor " << argv[5] << " invalido" << std::endl;
-    }
-  // Si el tipo de frontera es periódica, ajusta los estados de las células en los bordes.
-  } else if (borderType == PERIODIC) {
-    cells_[0] = cells_[size_ - 2];
-    cells_[size_ - 1] = cells_[1];
-  // Si el tipo de frontera es reflejante, ajusta los estados de las células en los bordes.
-  } else if (borderType == REFLECTIVE) {
-    cells_[0] = cells_[1];
-    cells_[size_ - 1] = cells_[size_ - 2];
+    current_[0] = current_[size_ - 1] = openState;
   }
+  // Si el tipo de frontera es periódica o reflejante, ajusta los estados de las células en los bordes.
+  UpdateBorders();
+  // La frontera abierta no cambia, así que el otro búfer empieza con ella ya colocada
+  next_ = current_;
 }
 
 /**
@@ -66,8 +50,9 @@ Lattice::Lattice(const int& size, const BorderType& borderType, char* argv[]) {
  * Si el tipo de frontera es de bucle, se ajustan los estados de las células en los bordes.
  * Si el tipo de frontera es frío, no se hace nada.
  * Además, se lee el estado inicial del autómata celular desde un archivo.
+ * @param openState estado de las células frontera si la frontera es abierta
  */
-Lattice::Lattice(const int size, const BorderType& borderType, const std::string& file_name, char* argv[]) {
+Lattice::Lattice(const int size, const BorderType& borderType, const State& openState, const std::string& file_name) {
   std::ifstream input_file{file_name};
   // verifica si el archivo se abrió correctamente
   if (!input_file.is_open()) {
@@ -88,101 +73,201 @@ Lattice::Lattice(const int size, const BorderType& borderType, const std::string
     }
     // Se ajusta el tamaño del retículo para incluir bordes.
     size_ = size + 2;
-    cells_.resize(size_);
     borderType_ = borderType;
-    State state_aux = DEAD;
-    // Se itera sobre todas las células en el retículo.
-    for (int i = 0, j = 0; i < size_; ++i) {
-      if (i == 0 || i == size_ - 1) {
-        state_aux = ALIVE;
-      } else {
-        state_aux = static_cast<State>(start_states[j++]);
-      }
-      cells_[i] = new Cell(i, state_aux);
+    // Las células frontera empiezan vivas y el resto con el estado leído
+    current_.assign(size_, ALIVE);
+    for (int i = 1; i < size_ - 1; ++i) {
+      current_[i] = static_cast<State>(start_states[i - 1]);
+      population_ += current_[i];
     }
     // si es abierta
     if (borderType == OPEN) {
-      if (atoi(argv[5]) == 0  || atoi(argv[5]) == 1) {
-        cells_[0] = new Cell(0, (State)atoi(argv[5]));
-        cells_[size_ - 1] = new Cell(size_ - 1, (State)atoi(argv[5]));
-      } else {
-        std::cout << "Error, valor " << argv[5] << " invalido" << std::endl;
-      }
-    }
-    // Si el tipo de frontera es periódica, ajusta los estados de las células en los bordes.
-    if (borderType_ == PERIODIC) {
-      cells_[0]->setState(cells_[size_ - 2]->getState());
-      cells_[size_ - 1]->setState(cells_[1]->getState());
-      
-    } else if (borderType_ == REFLECTIVE) {
-      cells_[0]->setState(cells_[1]->getState());
-      cells_[size_ - 1]->setState(cells_[size_ - 2]->getState());
+      current_[0] = current_[size_ - 1] = openState;
     }
+    // Si el tipo de frontera es periódica o reflejante, ajusta los estados de las células en los bordes.
+    UpdateBorders();
+    next_ = current_;
   }
 }
 
 /**
- * @brief Destructor de la clase para liberar la memoria de las células
- * Se encarga de liberar la memoria de las células.
- * Si no se hace esto, se producirá una fuga de memoria. Dara
+ * @brief Construct a new Lattice:: Lattice object
+ * Toma el tamaño, el tipo de frontera, el estado de la frontera abierta y la regla de la cabecera de
+ * una configuración binaria, y el estado de cada célula de su bit correspondiente.
+ * @param config configuración binaria ya proyectada en memoria
  */
-Lattice::~Lattice() {
+Lattice::Lattice(const BinaryConfig& config) : rule_(config.getRule()) {
+  size_ = config.getSize() + 2;
+  borderType_ = config.getBorderType();
+  current_.assign(size_, DEAD);
+  const uint8_t* bits = config.getCells();
   for (int i = 1; i < size_ - 1; ++i) {
-    delete cells_[i];
+    current_[i] = (bits[(i - 1) / 8] >> ((i - 1) % 8)) & 1;
+    population_ += current_[i];
+  }
+  // Las células frontera se colocan igual que en el constructor que lee el archivo de texto
+  if (borderType_ == OPEN) {
+    current_[0] = current_[size_ - 1] = config.getOpenState();
   }
+  UpdateBorders();
+  next_ = current_;
 }
 
 /**
  * @brief Método que devuelve la célula en la posición dada.
- * Se encarga de devolver la célula en la posición dada
- * @return const Cell& devuelve la célula en la posición dada
+ * La célula es una vista con la posición y el estado actual; no se guarda en el retículo.
+ * @return Cell devuelve la célula en la posición dada
+ */
+Cell Lattice::getCell(const Position& position) const {
+  return Cell(position, current_[position]);
+}
+
+/**
+ * @brief Método que coloca las células frontera.
+ * Si la frontera es periódica, cada una toma el estado de la célula del extremo opuesto; si es
+ * reflejante, el de la célula contigua. La frontera abierta no cambia.
  */
-const Cell& Lattice::getCell(const Position& position) const {
-  return *(cells_[position]);
+void Lattice::UpdateBorders() {
+  if (borderType_ == PERIODIC) {
+    current_[0] = current_[size_ - 2];
+    current_[size_ - 1] = current_[1];
+  } else if (borderType_ == REFLECTIVE) {
+    current_[0] = current_[1];
+    current_[size_ - 1] = current_[size_ - 2];
+  }
 }
 
 /**
  * @brief Función que evoluciona el autómata celular.
  * Se encarga de evolucionar el autómata celular
- * Hace dos recorridos sobre el retículo. En el primero, cada célula accede a su vecindad y calcula su estado siguiente.
- * En el segundo, cada célula actualiza su estado.
+ * Hace un único recorrido: el estado siguiente de cada célula se calcula con su vecindad en el búfer
+ * actual y se escribe en el otro búfer. Al terminar, se intercambian los búferes (solo sus punteros),
+ * así que no hace falta un segundo recorrido para copiar los estados.
  * Si la frontera es de tipo bucle, se ajustan los estados de las células en los bordes.
- * Esto se hace para que el retículo sea unidimensional y se pueda aplicar la regla 110.
+ * Esto se hace para que el retículo sea unidimensional y se pueda aplicar la regla elegida.
  */
 void Lattice::NextGeneration() { 
-  std::cout << "Número de células vivas: " << CountAliveCells() << std::endl;
-  // Si la frontera es de tipo periodico, se ajustan los estados de las células en los bordes.
-  if (borderType_ == PERIODIC) {
-    cells_[0]->setState(cells_[size_ - 2]->getState());
-    cells_[size_ - 1]->setState(cells_[1]->getState());
+  UpdateBorders();
+  // Cada célula accede a su vecindad y calcula su estado siguiente.
+  // A la vez se cuenta la población de la siguiente generación.
+  const uint8_t* current = current_.data();
+  uint8_t* next = next_.data();
+  std::size_t population = 0;
+  for (int i = 1; i < size_ - 1; ++i) {
+    next[i] = rule_.Apply(current[i - 1], current[i], current[i + 1]);
+    population += next[i];
   }
-  // Si la frontera es de tipo reflective, se ajustan los estados de las células en los bordes.
-  if (borderType_ == REFLECTIVE) {
-    cells_[0]->setState(cells_[1]->getState());
-    cells_[size_ - 1]->setState(cells_[size_ - 2]->getState());
+  current_.swap(next_);
+  population_ = population;
+  if (record_density_) {
+    density_.push_back(static_cast<double>(population_) / (size_ - 2));
   }
-  // Primer recorrido: Cada célula accede a su vecindad y calcula su estado siguiente.
-  for (int i = 1; i < size_ - 1; ++i) {
-    cells_[i]->Rule30(*this);
+  ++generation_;
+  if (detect_cycles_) {
+    cycles_.Record(Hash(), generation_);
   }
-  // Segundo recorido: Cada célula actualiza su estado.
-  for (int i = 1; i < size_ - 1; ++i) {
-    cells_[i]->UpdateState();
+}
+
+/**
+ * @brief Función que evoluciona el autómata celular varias generaciones.
+ * Tiene la misma interfaz que en PackedLattice para que el modo por lotes sirva con los dos retículos.
+ * Si se buscan ciclos, se para en la generación en la que se detecta el ciclo.
+ * @param generations número de generaciones
+ */
+void Lattice::Evolve(const long& generations) {
+  const bool searching = detect_cycles_ && !cycles_.Found();
+  for (long generation = 0; generation < generations && !(searching && cycles_.Found()); ++generation) {
+    NextGeneration();
+  }
+}
+
+/**
+ * @brief Método que activa o desactiva la detección de ciclos.
+ * El historial empieza con la generación actual.
+ * @param detect si se guarda el hash de cada generación
+ */
+void Lattice::setCycleDetection(const bool& detect) {
+  detect_cycles_ = detect;
+  cycles_.Reset();
+  if (detect_cycles_) {
+    cycles_.Record(Hash(), generation_);
+  }
+}
+
+/**
+ * @brief Método que salta a cualquier generación a partir del inicio del ciclo.
+ * La generación pedida tiene el mismo estado que la que está (generación - actual) módulo periodo
+ * generaciones por delante, así que como mucho se evoluciona un periodo.
+ * @param generation generación a la que se salta, mayor o igual que el transitorio
+ * @return true si se ha saltado, false si aún no se ha detectado el ciclo o la generación es anterior
+ */
+bool Lattice::FastForward(const long& generation) {
+  if (!cycles_.Found() || generation < cycles_.getTransient()) {
+    return false;
+  }
+  const long period = cycles_.getPeriod();
+  Evolve(((generation - generation_) % period + period) % period);
+  generation_ = generation;
+  return true;
+}
+
+/**
+ * @brief Método que devuelve el hash de 128 bits del estado actual.
+ * Se empaqueta el estado en palabras igual que en PackedLattice, así que los dos retículos dan el
+ * mismo hash para el mismo estado.
+ * @return StateHash hash del estado, sin la frontera
+ */
+StateHash Lattice::Hash() const {
+  std::vector<uint64_t> words((size_ - 2 + 63) / 64, 0);
+  PackRow(reinterpret_cast<uint8_t*>(words.data()), false);
+  return HashWords(words.data(), words.size());
+}
+
+/**
+ * @brief Método que activa o desactiva la serie temporal de densidad.
+ * Al activarla se guarda la densidad de la generación actual como primer valor.
+ * @param record si se guarda la densidad de cada generación
+ */
+void Lattice::setRecordDensity(const bool& record) {
+  record_density_ = record;
+  density_.clear();
+  if (record_density_) {
+    density_.push_back(static_cast<double>(population_) / (size_ - 2));
   }
 }
 
 /**
- * @brief Funcion que calcula las celulas vivas que quedan al final.
- * @return int retorna las celulas vivas
+ * @brief Método que escribe la generación actual con un bit por célula.
+ * Las células frontera no se escriben. Cada grupo de 8 células forma un byte.
+ * @param row destino, con sitio para (size - 2 + 7) / 8 bytes
+ * @param msb_first si la primera célula de cada byte va en el bit más significativo
  */
-int Lattice::CountAliveCells() const {
-  int aliveCount = 0;
-  for (const Cell* cell : cells_) {
-    if (cell->getState() == ALIVE) {
-      aliveCount++;
+void Lattice::PackRow(uint8_t* row, const bool& msb_first) const {
+  const int cells = size_ - 2;
+  for (int i = 0; i < cells; i += 8) {
+    uint8_t byte = 0;
+    for (int bit = 0; bit < 8 && i + bit < cells; ++bit) {
+      if (current_[i + bit + 1] == ALIVE) {
+        byte |= msb_first ? 0x80 >> bit : 1 << bit;
+      }
     }
+    row[i / 8] = byte;
+  }
+}
+
+/**
+ * @brief Método que carga una generación con un bit por célula, al revés que PackRow.
+ * La frontera se coloca al calcular la siguiente generación, como siempre.
+ * @param row origen, (size - 2 + 7) / 8 bytes con la primera célula de cada byte en el bit menos significativo
+ * @param generation generación que se carga
+ */
+void Lattice::LoadRow(const uint8_t* row, const long& generation) {
+  population_ = 0;
+  for (int i = 1; i < size_ - 1; ++i) {
+    current_[i] = (row[(i - 1) / 8] >> ((i - 1) % 8)) & 1;
+    population_ += current_[i];
   }
-  return aliveCount;
+  generation_ = generation;
 }
 
 /**
@@ -195,9 +280,9 @@ int Lattice::CountAliveCells() const {
 std::ostream& operator<<(std::ostream& os, const Lattice& lattice) {
   // Recorremos todo el retículo e imprimimos el estado de cada célula
   for (int i = 1; i < lattice.getSize() - 1; ++i) {
-    std::cout << lattice.getCell(i);
+    os << lattice.getCell(i);
   }
-  os << std::endl;
+  os << '\n';
   return os;
 }
 
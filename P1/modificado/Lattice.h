@@ -19,11 +19,14 @@
 #include <fstream>
 #include <new>
 #include <limits>
+#include <cstdint>
 
 #ifndef LATTICE_H
 #define LATTICE_H
 
 #include "Cell.h"
+#include "CycleDetector.h"
+#include "Rule.h"
 
 /**
  * @brief Enumerado que representa los tres posibles tipos de frontera
@@ -33,6 +36,8 @@ enum BorderType { PERIODIC, REFLECTIVE, OPEN };
 
 // Declaración adelantada de la clase Cell
 class Cell;
+// Declaración adelantada de la clase BinaryConfig
+class BinaryConfig;
 
 /**
  * @brief Clase Retículo 
@@ -42,27 +47,66 @@ class Cell;
 class Lattice {
  public:
   // Constructor al que se le pasa en tamaño del retículo y lo contruye
-  Lattice(const int& size, const BorderType& borderType, char* argv[]);
+  Lattice(const int& size, const BorderType& borderType, const State& openState);
   // Constructor al que se le pasa el tamaño del retículo, el tipo de frontera y el archivo de configuración inicial
-  Lattice(const int, const BorderType&, const std::string&, char* argv[]);
-  // Destructor de la clase para liberar la memoria de las células
-  ~Lattice();
+  Lattice(const int, const BorderType&, const State&, const std::string&);
+  // Constructor que toma el tamaño, la frontera y las células de una configuración binaria
+  explicit Lattice(const BinaryConfig&);
   // Getters de la clase
-  std::vector<Cell*> getCells() const { return cells_; }
   int getSize() const { return size_; }
-  // método que devuelve la célula en la posición dada.
-  const Cell& getCell(const Position&) const;
+  const Rule& getRule() const { return rule_; }
+  // setter de la regla que se aplica, dada por su código de Wolfram (0..255)
+  void setRule(const int& code) { rule_ = Rule(code); }
+  // método que devuelve una vista de la célula en la posición dada.
+  Cell getCell(const Position&) const;
   // método que evoluciona el autómata celular.
   void NextGeneration();
+  // método que evoluciona el autómata celular varias generaciones seguidas.
+  void Evolve(const long&);
+  // Getter de la generación actual (0 es la configuración inicial)
+  long getGeneration() const { return generation_; }
+  // método que activa o desactiva la detección de ciclos, empezando por la generación actual
+  void setCycleDetection(const bool&);
+  // Getter del detector de ciclos, con el transitorio y el periodo si ya se han detectado
+  const CycleDetector& getCycles() const { return cycles_; }
+  // método que salta a cualquier generación del ciclo ya detectado; false si no se puede
+  bool FastForward(const long& generation);
+  // método que devuelve el hash de 128 bits del estado actual (el mismo que en PackedLattice)
+  StateHash Hash() const;
+  // método que escribe la generación actual con un bit por célula, (size - 2 + 7) / 8 bytes
+  void PackRow(uint8_t* row, const bool& msb_first) const;
+  // método que carga una generación escrita por PackRow (primera célula en el bit menos significativo)
+  void LoadRow(const uint8_t* row, const long& generation);
   // método que imprime el estado del retículo.
   friend std::ostream& operator<<(std::ostream&, const Lattice&);
-  // Metodo que te cuenta al acabar el numero de celulas vivas
-  int CountAliveCells() const;
+  // Metodo que devuelve el numero de celulas vivas (sin la frontera). Se calcula al evolucionar,
+  // así que no recorre el retículo.
+  std::size_t CountAliveCells() const { return population_; }
+  // método que activa o desactiva la serie temporal de densidad (células vivas / tamaño)
+  void setRecordDensity(const bool&);
+  // Getter de la serie temporal de densidad, un valor por generación
+  const std::vector<double>& getDensity() const { return density_; }
  private:
-  std::vector<Cell*> cells_;
+  // método que copia en las células frontera los estados que les corresponden según la frontera
+  void UpdateBorders();
+  // estados de la generación actual y de la siguiente, un byte por célula con la frontera en las
+  // posiciones 0 y size - 1. Al terminar cada generación se intercambian.
+  std::vector<uint8_t> current_;
+  std::vector<uint8_t> next_;
   int size_;
   // tipo de frontera
   BorderType borderType_;
+  // regla que se aplica, por defecto la 30
+  Rule rule_{30};
+  // número de células vivas, sin contar la frontera
+  std::size_t population_ = 0;
+  // si se guarda la serie temporal de densidad y la serie
+  bool record_density_ = false;
+  std::vector<double> density_;
+  // generación actual, si se buscan ciclos y el historial de hashes
+  long generation_ = 0;
+  bool detect_cycles_ = false;
+  CycleDetector cycles_;
 };
 
 // Sobrecarga del operador de salida
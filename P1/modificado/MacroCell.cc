@@ -0,0 +1,239 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file MacroCell.cc
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Implementación de los métodos de la clase MacroCellEngine.
+ */
+
+#include <algorithm>
+
+#include "MacroCell.h"
+
+/**
+ * @brief Construct a new MacroCellEngine:: MacroCellEngine object
+ * Los nodos que se construyen para cada bloque tienen el nivel justo para avanzar el salto completo,
+ * y como mínimo el del caso base.
+ * @param rule regla que se aplica
+ * @param log_step logaritmo en base 2 de las generaciones de cada salto
+ */
+MacroCellEngine::MacroCellEngine(const Rule& rule, const int& log_step)
+    : kernel_(rule.getCode()), log_step_(log_step), level_(std::max(kBaseLevel, log_step + 2)) {}
+
+/**
+ * @brief Método que avanza un salto todas las células del anillo.
+ * El anillo se divide en bloques de 2^(level - 1) células. Cada bloque es el resultado del nodo de
+ * nivel level que empieza media anchura de bloque a su izquierda. Las posiciones se toman módulo
+ * size, como en la frontera periódica.
+ * Los bits de la última palabra que sobran tras la última célula quedan con basura y hay que limpiarlos.
+ * @param current células de la generación actual
+ * @param next donde se escriben las células tras el salto
+ * @param size número de células
+ */
+void MacroCellEngine::Advance(const uint64_t* current, uint64_t* next, const std::size_t& size) {
+  // La tabla se vacía entre saltos para que la memoria no crezca sin límite
+  if (nodes_.size() > kMaxNodes) {
+    Clear();
+  }
+  current_ = current;
+  size_ = size;
+  built_.clear();
+  const std::size_t block = std::size_t{1} << (level_ - 1);
+  const std::size_t offset = size - (block / 2) % size;
+  for (std::size_t start = 0; start < size; start += block) {
+    Write(Result(Build(level_, (start + offset) % size)), start, next);
+  }
+}
+
+/**
+ * @brief Método que devuelve la hoja canónica con las células dadas
+ * @param word células de la hoja
+ * @return uint32_t índice del nodo
+ */
+uint32_t MacroCellEngine::Leaf(const uint64_t& word) {
+  const auto found = leaves_.find(word);
+  if (found != leaves_.end()) {
+    return found->second;
+  }
+  const uint32_t id = nodes_.size();
+  nodes_.push_back({kNone, kNone, word, kLeafLevel, kNone});
+  leaves_.emplace(word, id);
+  return id;
+}
+
+/**
+ * @brief Método que devuelve el nodo canónico formado por dos hijos del mismo nivel
+ * @param left mitad izquierda
+ * @param right mitad derecha
+ * @return uint32_t índice del nodo
+ */
+uint32_t MacroCellEngine::Join(const uint32_t& left, const uint32_t& right) {
+  const uint64_t key = (static_cast<uint64_t>(left) << 32) | right;
+  const auto found = joins_.find(key);
+  if (found != joins_.end()) {
+    return found->second;
+  }
+  const uint32_t id = nodes_.size();
+  nodes_.push_back({left, right, 0, nodes_[left].level + 1, kNone});
+  joins_.emplace(key, id);
+  return id;
+}
+
+/**
+ * @brief Método que devuelve la mitad central de un nodo, en la misma generación
+ * @param id nodo de nivel kBaseLevel o mayor
+ * @return uint32_t nodo de un nivel menos
+ */
+uint32_t MacroCellEngine::Centre(const uint32_t& id) {
+  // Se copian los datos: nodes_ puede crecer (y moverse) al crear el nodo central
+  const Node left = nodes_[nodes_[id].left];
+  const Node right = nodes_[nodes_[id].right];
+  if (nodes_[id].level == kBaseLevel) {
+    return Leaf((left.word >> 32) | (right.word << 32));
+  }
+  return Join(left.right, right.left);
+}
+
+/**
+ * @brief Método que calcula el resultado de un nodo: su mitad central tras el avance que le toca.
+ * Un nodo de nivel L con hijos A y B se divide en cuartos y se forman tres nodos de nivel L - 1:
+ * A, el del medio y B. Sus resultados (r0, r1, r2) cubren la mitad central en una generación
+ * intermedia y, uniéndolos de dos en dos, los resultados de (r0, r1) y (r1, r2) son las dos mitades
+ * del resultado de este nodo.
+ * Si el nodo avanza su máximo (2^(L-2) generaciones), cada fase avanza la mitad. Si el salto es menor,
+ * la primera fase solo toma los centros y toda la evolución la hace la segunda.
+ * @param id nodo de nivel kBaseLevel o mayor
+ * @return uint32_t nodo resultado, de un nivel menos
+ */
+uint32_t MacroCellEngine::Result(const uint32_t& id) {
+  if (nodes_[id].result != kNone) {
+    return nodes_[id].result;
+  }
+  const int level = nodes_[id].level;
+  uint32_t result;
+  if (level == kBaseLevel) {
+    result = BaseResult(id);
+  } else {
+    // Se copian los índices: nodes_ puede crecer (y moverse) durante la recursión
+    const uint32_t left = nodes_[id].left;
+    const uint32_t right = nodes_[id].right;
+    const uint32_t left_right = nodes_[left].right;
+    const uint32_t right_left = nodes_[right].left;
+    const uint32_t middle = Join(left_right, right_left);
+    uint32_t r0, r1, r2;
+    if (log_step_ >= level - 2) {
+      r0 = Result(left);
+      r1 = Result(middle);
+      r2 = Result(right);
+    } else {
+      r0 = Centre(left);
+      r1 = Centre(middle);
+      r2 = Centre(right);
+    }
+    const uint32_t first = Result(Join(r0, r1));
+    result = Join(first, Result(Join(r1, r2)));
+  }
+  nodes_[id].result = result;
+  return result;
+}
+
+/**
+ * @brief Método que calcula el resultado de un nodo de 128 células por fuerza bruta.
+ * Se evolucionan las dos palabras como una sola de 128 bits. Las células de los extremos se
+ * estropean una por generación, pero en 32 generaciones como mucho no llegan a las 64 centrales.
+ * @param id nodo de nivel kBaseLevel
+ * @return uint32_t hoja con las 64 células centrales
+ */
+uint32_t MacroCellEngine::BaseResult(const uint32_t& id) {
+  uint64_t low = nodes_[nodes_[id].left].word;
+  uint64_t high = nodes_[nodes_[id].right].word;
+  const int generations = 1 << std::min(log_step_, kBaseLevel - 2);
+  for (int generation = 0; generation < generations; ++generation) {
+    const uint64_t next_low = kernel_(low << 1, low, (low >> 1) | (high << 63));
+    high = kernel_((high << 1) | (low >> 63), high, high >> 1);
+    low = next_low;
+  }
+  return Leaf((low >> 32) | (high << 32));
+}
+
+/**
+ * @brief Método que construye el nodo de nivel level que empieza en la célula position del anillo.
+ * Los nodos ya construidos en este salto se guardan por nivel y posición: en un anillo pequeño y un
+ * salto grande el mismo trozo aparece muchas veces y así se construye solo una.
+ * @param level nivel del nodo
+ * @param position primera célula, menor que size
+ * @return uint32_t índice del nodo
+ */
+uint32_t MacroCellEngine::Build(const int& level, const std::size_t& position) {
+  const uint64_t key = (static_cast<uint64_t>(position) << 6) | level;
+  const auto found = built_.find(key);
+  if (found != built_.end()) {
+    return found->second;
+  }
+  uint32_t id;
+  if (level == kLeafLevel) {
+    id = Leaf(ReadWord(position));
+  } else {
+    const std::size_t half = (std::size_t{1} << (level - 1)) % size_;
+    const uint32_t left = Build(level - 1, position);
+    id = Join(left, Build(level - 1, (position + half) % size_));
+  }
+  built_.emplace(key, id);
+  return id;
+}
+
+/**
+ * @brief Método que lee 64 células seguidas del anillo.
+ * Si no se pasa del final basta con combinar dos palabras; si se pasa, se leen una a una dando la vuelta.
+ * @param position primera célula, menor que size
+ * @return uint64_t células leídas, la primera en el bit 0
+ */
+uint64_t MacroCellEngine::ReadWord(const std::size_t& position) const {
+  const std::size_t word = position / 64;
+  const std::size_t shift = position % 64;
+  if (position + 64 <= size_) {
+    if (shift == 0) {
+      return current_[word];
+    }
+    return (current_[word] >> shift) | (current_[word + 1] << (64 - shift));
+  }
+  uint64_t value = 0;
+  std::size_t cell = position;
+  for (int bit = 0; bit < 64; ++bit) {
+    value |= ((current_[cell / 64] >> (cell % 64)) & 1) << bit;
+    if (++cell == size_) {
+      cell = 0;
+    }
+  }
+  return value;
+}
+
+/**
+ * @brief Método que escribe las células de un nodo a partir de una célula múltiplo de 64.
+ * Las partes que empiezan después de la última célula no se escriben.
+ * @param id nodo
+ * @param position primera célula, múltiplo de 64
+ * @param next palabras de destino
+ */
+void MacroCellEngine::Write(const uint32_t& id, const std::size_t& position, uint64_t* next) const {
+  if (position >= size_) {
+    return;
+  }
+  const Node& node = nodes_[id];
+  if (node.level == kLeafLevel) {
+    next[position / 64] = node.word;
+    return;
+  }
+  Write(node.left, position, next);
+  Write(node.right, position + (std::size_t{1} << (node.level - 1)), next);
+}
+
+/**
+ * @brief Método que vacía la tabla de nodos y los resultados guardados
+ */
+void MacroCellEngine::Clear() {
+  nodes_.clear();
+  leaves_.clear();
+  joins_.clear();
+}
\ No newline at end of file
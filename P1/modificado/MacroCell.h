@@ -0,0 +1,90 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file MacroCell.h
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Creación de la clase MacroCellEngine (evaluación memorizada al estilo HashLife).
+ * Un bloque de 2^L células se representa con un nodo de nivel L: los de nivel 6 son hojas con una
+ * palabra de 64 células y los demás tienen dos hijos, la mitad izquierda y la derecha. Los nodos son
+ * canónicos (cada bloque distinto existe una sola vez), así que los bloques repetidos comparten nodo.
+ * Como la información avanza como mucho una célula por generación, las 2^(L-1) células centrales de
+ * un nodo de nivel L solo dependen de él durante 2^(L-2) generaciones. Ese resultado se calcula de
+ * forma recursiva a partir de los hijos y se guarda en el propio nodo, así que cada bloque distinto
+ * se calcula una sola vez aunque aparezca en muchas posiciones o en muchos saltos.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#ifndef MACROCELL_H
+#define MACROCELL_H
+
+#include "Rule.h"
+
+/**
+ * @brief Clase Motor de macro-células
+ * Avanza un retículo periódico 2^log_step generaciones de una vez. El retículo se recorre en bloques
+ * de salida y, para cada uno, se construye el nodo que lo contiene junto con su cono de luz (leyendo
+ * el anillo de forma periódica, así que sirve aunque el salto sea mayor que el retículo).
+ */
+class MacroCellEngine {
+ public:
+  // Constructor que recibe la regla y el logaritmo en base 2 del número de generaciones de cada salto
+  MacroCellEngine(const Rule& rule, const int& log_step);
+  // Getter del número de generaciones de cada salto
+  long getGenerations() const { return 1L << log_step_; }
+  // Getter del número de nodos canónicos guardados
+  std::size_t getNodeCount() const { return nodes_.size(); }
+  // método que avanza un salto las células de current (célula i en el bit i % 64 de la palabra i / 64)
+  void Advance(const uint64_t* current, uint64_t* next, const std::size_t& size);
+
+ private:
+  // Nivel de las hojas (64 células) y de los nodos que se calculan por fuerza bruta (128 células)
+  static constexpr int kLeafLevel = 6;
+  static constexpr int kBaseLevel = 7;
+  // Máximo de nodos antes de vaciar la tabla
+  static constexpr std::size_t kMaxNodes = 1 << 22;
+  // Índice que indica que el resultado de un nodo aún no se ha calculado
+  static constexpr uint32_t kNone = UINT32_MAX;
+  /**
+   * @brief Nodo canónico. Las hojas guardan sus células en word, los demás nodos sus dos hijos.
+   */
+  struct Node {
+    uint32_t left;
+    uint32_t right;
+    uint64_t word;
+    int level;
+    uint32_t result; // nodo central tras min(2^log_step, 2^(level-2)) generaciones
+  };
+  // métodos que devuelven el nodo canónico de una hoja y de un par de hijos
+  uint32_t Leaf(const uint64_t& word);
+  uint32_t Join(const uint32_t& left, const uint32_t& right);
+  // método que devuelve el nodo central (la mitad central, sin avanzar en el tiempo)
+  uint32_t Centre(const uint32_t& id);
+  // método que calcula (o devuelve el ya guardado) resultado de un nodo
+  uint32_t Result(const uint32_t& id);
+  // método que calcula el resultado de un nodo de nivel kBaseLevel evolucionando sus 128 células
+  uint32_t BaseResult(const uint32_t& id);
+  // método que construye el nodo de nivel level que empieza en la célula position del anillo
+  uint32_t Build(const int& level, const std::size_t& position);
+  // método que lee 64 células del anillo a partir de position
+  uint64_t ReadWord(const std::size_t& position) const;
+  // método que escribe las células de un nodo en next a partir de position, sin pasar de size
+  void Write(const uint32_t& id, const std::size_t& position, uint64_t* next) const;
+  // método que vacía la tabla de nodos
+  void Clear();
+  TableKernel kernel_; // núcleo de la regla para el caso base
+  int log_step_; // logaritmo en base 2 de las generaciones de cada salto
+  int level_; // nivel de los nodos que se construyen para cada bloque de salida
+  std::vector<Node> nodes_; // nodos canónicos
+  std::unordered_map<uint64_t, uint32_t> leaves_; // hojas por su palabra
+  std::unordered_map<uint64_t, uint32_t> joins_; // nodos por su par de hijos
+  std::unordered_map<uint64_t, uint32_t> built_; // nodos ya construidos en este salto, por nivel y posición
+  const uint64_t* current_ = nullptr; // anillo que se está leyendo
+  std::size_t size_ = 0; // número de células del anillo
+};
+
+#endif // MACROCELL_H
\ No newline at end of file
@@ -0,0 +1,917 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file PackedLattice.cc
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Implementación de los métodos de la clase PackedLattice.
+ * Encontramos los constructores, el acceso a las células, la colocación de las células frontera,
+ * el método que evoluciona el autómata celular aplicando la regla palabra a palabra,
+ * el método que cuenta las células vivas y la sobrecarga del operador de salida.
+ */
+
+#include "PackedLattice.h"
+
+/**
+ * @brief Función que devuelve el número counter de la secuencia de splitmix64 que empieza en key.
+ * No tiene estado: el número se calcula directamente desde su posición, así que cada palabra se
+ * puede generar por separado, en cualquier orden y en cualquier hilo, y siempre sale la misma.
+ */
+static uint64_t RandomWord(const uint64_t& key, const uint64_t& counter) {
+  return Mix64(key + (counter + 1) * 0x9e3779b97f4a7c15ULL);
+}
+
+/**
+ * @brief Constructor que se encarga de inicializar el retículo cuando no hay archivo de configuración inicial.
+ * Igual que en Lattice, solo la célula central empieza viva.
+ * @param size número de células del retículo
+ * @param borderType tipo de frontera
+ * @param openState estado de las células frontera si la frontera es abierta
+ * @param rule código de Wolfram de la regla que se aplica
+ */
+PackedLattice::PackedLattice(const int& size, const BorderType& borderType, const State& openState, const int& rule)
+    : size_(size), borderType_(borderType), openState_(openState), rule_(rule) {
+  words_ = (static_cast<std::size_t>(size_) + 63) / 64;
+  tail_mask_ = (size_ % 64 == 0) ? ~0ULL : ((1ULL << (size_ % 64)) - 1);
+  current_.assign(words_ + 2 * kPadWords, 0);
+  next_.assign(words_ + 2 * kPadWords, 0);
+  // La célula central es la misma que en Lattice: (size + 2) / 2 contando la frontera
+  setState(size_ / 2, ALIVE);
+}
+
+/**
+ * @brief Constructor que se encarga de inicializar el retículo cuando se le pasa un archivo de configuración inicial.
+ * El archivo tiene el mismo formato que el de Lattice: un 0 o un 1 por célula separados por espacios.
+ * @param size número de células del retículo
+ * @param borderType tipo de frontera
+ * @param openState estado de las células frontera si la frontera es abierta
+ * @param rule código de Wolfram de la regla que se aplica
+ * @param file_name nombre del archivo de configuración inicial
+ */
+PackedLattice::PackedLattice(const int size, const BorderType& borderType, const State& openState, const int& rule,
+                             const std::string& file_name)
+    : size_(size), borderType_(borderType), openState_(openState), rule_(rule) {
+  std::ifstream input_file{file_name};
+  // verifica si el archivo se abrió correctamente
+  if (!input_file.is_open()) {
+    std::cerr << "File could not be opened." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  words_ = (static_cast<std::size_t>(size_) + 63) / 64;
+  tail_mask_ = (size_ % 64 == 0) ? ~0ULL : ((1ULL << (size_ % 64)) - 1);
+  current_.assign(words_ + 2 * kPadWords, 0);
+  next_.assign(words_ + 2 * kPadWords, 0);
+  // Se lee el estado inicial directamente sobre los bits
+  int state, read = 0;
+  while (input_file >> state) {
+    if (read < size_) {
+      setState(read, static_cast<State>(state));
+    }
+    ++read;
+  }
+  // Se verifica si el tamaño especificado en la opción "-size" coincide con el número de estados en el archivo.
+  if (read != size_) {
+    std::cerr << "Size specified in option \"-size\" does not match with the number of states in the file " << file_name << "." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+/**
+ * @brief Constructor que se encarga de inicializar el retículo desde una configuración binaria.
+ * Las células ya están empaquetadas en el mismo orden que las palabras, así que se copian con un
+ * solo memcpy desde la proyección del archivo y la población se cuenta palabra a palabra.
+ * @param config configuración binaria ya proyectada en memoria
+ */
+PackedLattice::PackedLattice(const BinaryConfig& config)
+    : size_(config.getSize()), borderType_(config.getBorderType()), openState_(config.getOpenState()),
+      rule_(config.getRule()) {
+  words_ = (static_cast<std::size_t>(size_) + 63) / 64;
+  tail_mask_ = (size_ % 64 == 0) ? ~0ULL : ((1ULL << (size_ % 64)) - 1);
+  current_.assign(words_ + 2 * kPadWords, 0);
+  next_.assign(words_ + 2 * kPadWords, 0);
+  std::memcpy(current_.data() + kPadWords, config.getCells(), (static_cast<std::size_t>(size_) + 7) / 8);
+  current_[kPadWords + words_ - 1] &= tail_mask_;
+  for (std::size_t k = kPadWords; k < kPadWords + words_; ++k) {
+    population_ += __builtin_popcountll(current_[k]);
+  }
+}
+
+/**
+ * @brief Método que devuelve el estado de la célula en la posición dada.
+ * @param position posición de la célula, entre 0 y size - 1
+ * @return State estado de la célula
+ */
+State PackedLattice::getState(const Position& position) const {
+  return (current_[kPadWords + position / 64] >> (position % 64)) & 1ULL;
+}
+
+/**
+ * @brief Setter que establece el estado de la célula en la posición dada.
+ * @param position posición de la célula, entre 0 y size - 1
+ * @param state estado nuevo de la célula
+ */
+void PackedLattice::setState(const Position& position, const State& state) {
+  uint64_t& word = current_[kPadWords + position / 64];
+  const uint64_t bit = 1ULL << (position % 64);
+  // Se actualiza la población con la diferencia
+  population_ += static_cast<std::size_t>(state) - ((word & bit) != 0);
+  word = state ? (word | bit) : (word & ~bit);
+}
+
+/**
+ * @brief Método que pone cada célula viva al azar con probabilidad density.
+ * La probabilidad se redondea a t / 2^32 y cada célula está viva si un número aleatorio u de 32 bits
+ * es menor que t. Para hacerlo con 64 células a la vez se recorren los bits de t desde el menos
+ * significativo: con cada uno se toma una palabra aleatoria (un bit de u por célula) y se hace OR con
+ * el resultado si el bit es 1 o AND si es 0. Así, una densidad de 1/2 cuesta una palabra aleatoria
+ * y una de 1/2^k, k.
+ * La palabra aleatoria j de la palabra k del retículo es el número 32 * k + j de la secuencia de la
+ * semilla, así que el resultado no depende de cómo se repartan las palabras entre los hilos.
+ * @param density probabilidad de que cada célula esté viva, entre 0 y 1
+ * @param seed semilla
+ */
+void PackedLattice::Randomize(const double& density, const uint64_t& seed) {
+  const uint64_t threshold = std::llround(std::min(std::max(density, 0.0), 1.0) * 4294967296.0);
+  const int lowest = threshold == 0 ? 32 : __builtin_ctzll(threshold);
+  const uint64_t key = Mix64(seed);
+  const std::size_t threads = pool_ != nullptr ? pool_->getThreads() : 1;
+  const std::size_t chunk = (words_ + threads - 1) / threads;
+  std::vector<std::size_t> partial(threads, 0);
+  const auto task = [&](std::size_t id) {
+    const std::size_t begin = std::min(id * chunk, words_), end = std::min(begin + chunk, words_);
+    for (std::size_t k = begin; k < end; ++k) {
+      uint64_t word = threshold >> 32 ? ~0ULL : 0;
+      for (int bit = lowest; bit < 32; ++bit) {
+        const uint64_t random = RandomWord(key, 32 * k + (bit - lowest));
+        word = (threshold >> bit) & 1ULL ? word | random : word & random;
+      }
+      word &= k + 1 == words_ ? tail_mask_ : ~0ULL;
+      current_[kPadWords + k] = word;
+      partial[id] += __builtin_popcountll(word);
+    }
+  };
+  if (pool_ != nullptr) {
+    pool_->Run(task);
+  } else {
+    task(0);
+  }
+  population_ = 0;
+  for (const std::size_t& count : partial) {
+    population_ += count;
+  }
+}
+
+/**
+ * @brief Método que activa o desactiva la serie temporal de densidad.
+ * Al activarla se guarda la densidad de la generación actual como primer valor.
+ * @param record si se guarda la densidad de cada generación
+ */
+void PackedLattice::setRecordDensity(const bool& record) {
+  record_density_ = record;
+  density_.clear();
+  if (record_density_) {
+    density_.push_back(static_cast<double>(population_) / size_);
+  }
+}
+
+/**
+ * @brief Método que coloca las células frontera antes de calcular la siguiente generación.
+ * La frontera izquierda es el último bit de la palabra anterior a la primera y la derecha el bit
+ * siguiente a la última célula, que puede caer en la última palabra útil o en la primera de relleno.
+ * Si es periódica, se copian las células del extremo contrario.
+ * Si es reflectora, se copian las células del propio extremo.
+ * Si es abierta, se pone el valor fijo indicado por línea de comandos.
+ */
+void PackedLattice::UpdateBorders() {
+  State left = openState_, right = openState_;
+  if (borderType_ == PERIODIC) {
+    left = getState(size_ - 1);
+    right = getState(0);
+  } else if (borderType_ == REFLECTIVE) {
+    left = getState(0);
+    right = getState(size_ - 1);
+  }
+  current_[kPadWords - 1] = static_cast<uint64_t>(left) << 63;
+  // Se limpian los bits que sobran de la última palabra antes de colocar la frontera derecha
+  current_[kPadWords + words_ - 1] &= tail_mask_;
+  current_[kPadWords + words_] = 0;
+  uint64_t& word = current_[kPadWords + size_ / 64];
+  word |= static_cast<uint64_t>(right) << (size_ % 64);
+}
+
+/**
+ * @brief Función que evoluciona el autómata celular una generación.
+ * Si hay varios hilos, se usa Evolve para repartir el retículo entre ellos.
+ */
+void PackedLattice::NextGeneration() {
+  if (pool_ != nullptr) {
+    Evolve(1);
+    return;
+  }
+  UpdateBorders();
+  if (detect_cycles_ && cycles_.Searching()) {
+    StateHash hash{0, 0};
+    const std::size_t population = StepRange(current_.data(), next_.data(), kPadWords, kPadWords + words_, hash);
+    FinishGeneration(population, 1, &hash);
+    return;
+  }
+  FinishGeneration(StepRange(current_.data(), next_.data(), kPadWords, kPadWords + words_));
+}
+
+/**
+ * @brief Función que evoluciona el autómata celular varias generaciones.
+ * Si hay motor de macro-células, se avanza a saltos mientras quepan. Después, si hay bloqueo temporal,
+ * se avanza de block_depth_ en block_depth_ generaciones por teselas. Si se buscan ciclos, se para
+ * en la generación en la que se detecta el ciclo.
+ * Con un solo hilo equivale a llamar a NextGeneration. Con varios, el retículo se divide en trozos
+ * contiguos de palabras, uno por hilo. Cada hilo lee la palabra anterior y la siguiente a su trozo
+ * (el halo) directamente del buffer compartido de la generación actual, que nadie modifica durante
+ * el cálculo. Al terminar cada generación los hilos se esperan en una barrera y el último en llegar
+ * suma las poblaciones, intercambia los buffers y coloca la frontera de la siguiente generación.
+ * Si se buscan ciclos, cada hilo calcula también la parte del hash de su trozo y el último las suma.
+ * @param generations número de generaciones
+ */
+void PackedLattice::Evolve(const long& generations) {
+  long remaining = generations;
+  // Si se están buscando ciclos, se para en cuanto se detecta uno
+  const bool searching = detect_cycles_ && !cycles_.Found();
+  // Con el motor de macro-células se avanza a saltos y solo lo que sobra se hace paso a paso
+  if (macro_cell_ != nullptr) {
+    for (; remaining >= macro_cell_->getGenerations(); remaining -= macro_cell_->getGenerations()) {
+      Jump();
+    }
+  }
+  // Las teselas solo dejan la última generación de cada bloque, así que no sirven si hace falta el
+  // hash o la densidad de todas
+  if (block_depth_ > 1 && !detect_cycles_ && !record_density_) {
+    for (; remaining >= block_depth_; remaining -= block_depth_) {
+      BlockStep();
+    }
+  }
+  if (pool_ == nullptr) {
+    for (long generation = 0; generation < remaining && !(searching && cycles_.Found()); ++generation) {
+      NextGeneration();
+    }
+    return;
+  }
+  const std::size_t threads = pool_->getThreads();
+  // Los trozos son múltiplos de 8 palabras para no partir los vectores de la versión SIMD
+  const std::size_t chunk = ((words_ + threads - 1) / threads + 7) / 8 * 8;
+  std::vector<std::size_t> partial(threads, 0);
+  std::vector<StateHash> hashes(threads);
+  Barrier barrier(threads);
+  const auto completion = [this, &partial, &hashes] {
+    std::size_t population = 0;
+    for (const std::size_t& count : partial) {
+      population += count;
+    }
+    if (detect_cycles_ && cycles_.Searching()) {
+      StateHash hash{0, 0};
+      for (const StateHash& part : hashes) {
+        hash += part;
+      }
+      FinishGeneration(population, 1, &hash);
+    } else {
+      FinishGeneration(population);
+    }
+    UpdateBorders();
+  };
+  UpdateBorders();
+  pool_->Run([&](std::size_t id) {
+    const std::size_t begin = std::min(kPadWords + id * chunk, kPadWords + words_);
+    const std::size_t end = std::min(begin + chunk, kPadWords + words_);
+    for (long generation = 0; generation < remaining; ++generation) {
+      if (detect_cycles_ && cycles_.Searching()) {
+        hashes[id] = StateHash{0, 0};
+        partial[id] = StepRange(current_.data(), next_.data(), begin, end, hashes[id]);
+      } else {
+        partial[id] = StepRange(current_.data(), next_.data(), begin, end);
+      }
+      barrier.ArriveAndWait(completion);
+      // Todos los hilos leen el mismo valor, escrito por la finalización antes de salir de la barrera
+      if (searching && cycles_.Found()) {
+        break;
+      }
+    }
+  });
+}
+
+/**
+ * @brief Método que cambia el número de hilos con los que se evoluciona el retículo.
+ * Los hilos se crean una sola vez y se reutilizan en todas las generaciones.
+ * @param threads número de hilos, 1 para evolucionar en el hilo principal
+ */
+void PackedLattice::setThreads(const std::size_t& threads) {
+  if (threads > 1) {
+    pool_.reset(new ThreadPool(threads));
+  } else {
+    pool_.reset();
+  }
+}
+
+/**
+ * @brief Método que activa o desactiva el motor de macro-células.
+ * Solo tiene sentido con frontera periódica: el motor trata el retículo como un anillo.
+ * @param log_step logaritmo en base 2 de las generaciones de cada salto, -1 para desactivarlo
+ */
+void PackedLattice::setJump(const int& log_step) {
+  if (log_step >= 0) {
+    macro_cell_.reset(new MacroCellEngine(rule_, log_step));
+  } else {
+    macro_cell_.reset();
+  }
+}
+
+/**
+ * @brief Método que avanza un salto completo con el motor de macro-células.
+ * El motor escribe el resultado en el otro buffer y se cierra como una generación normal, contando
+ * la población de una pasada. La densidad se guarda una vez por salto.
+ */
+void PackedLattice::Jump() {
+  macro_cell_->Advance(current_.data() + kPadWords, next_.data() + kPadWords, size_);
+  std::size_t population = 0;
+  for (std::size_t k = kPadWords; k < kPadWords + words_; ++k) {
+    population += __builtin_popcountll(next_[k]);
+  }
+  FinishGeneration(population, macro_cell_->getGenerations());
+}
+
+/**
+ * @brief Método que avanza block_depth_ generaciones con bloqueo temporal.
+ * Cuando el retículo no cabe en la caché, cada generación lee y escribe todo el retículo en memoria
+ * y el paso queda limitado por el ancho de banda. Aquí el retículo se divide en teselas de
+ * kTileWords palabras: cada tesela se copia con un halo de block_depth_ células a cada lado en dos
+ * buffers locales, avanza ahí todas las generaciones y se escribe una sola vez en el otro buffer.
+ * Con varios hilos, cada uno toma teselas alternas con sus propios buffers locales; como todas leen
+ * de la generación actual y escriben en trozos distintos de la siguiente, no hace falta sincronizarlas.
+ */
+void PackedLattice::BlockStep() {
+  const std::size_t halo = (block_depth_ + 63) / 64;
+  const std::size_t tile = std::min(kTileWords, words_);
+  const std::size_t tiles = (words_ + tile - 1) / tile;
+  const std::size_t threads = pool_ != nullptr ? pool_->getThreads() : 1;
+  std::vector<std::size_t> partial(threads, 0);
+  const auto task = [&](std::size_t id) {
+    // Una palabra de relleno, el halo, la tesela, el halo y otra palabra de relleno
+    std::vector<uint64_t> current(tile + 2 * halo + 2, 0);
+    std::vector<uint64_t> next(current.size(), 0);
+    for (std::size_t index = id; index < tiles; index += threads) {
+      const std::size_t first = index * tile;
+      partial[id] += StepTile(current.data(), next.data(), first, std::min(tile, words_ - first), halo);
+    }
+  };
+  if (pool_ != nullptr) {
+    pool_->Run(task);
+  } else {
+    task(0);
+  }
+  std::size_t population = 0;
+  for (const std::size_t& count : partial) {
+    population += count;
+  }
+  FinishGeneration(population, block_depth_);
+}
+
+/**
+ * @brief Método que avanza una tesela block_depth_ generaciones.
+ * La palabra local w es la palabra global first - halo - 1 + w. En cada generación el trozo válido
+ * se estrecha una célula por cada lado (un trapecio), así que solo se calculan las palabras que aún
+ * influyen en la tesela: en la última generación, exactamente las de la tesela.
+ * Con frontera periódica el halo se toma del otro extremo y el anillo desenrollado evoluciona igual
+ * que el original. Con frontera abierta o reflectora eso no vale (la célula frontera no evoluciona
+ * según la regla), así que las teselas de los extremos vuelven a colocar la célula frontera en cada
+ * generación y lo que queda fuera del retículo se ignora.
+ * @param current buffer local con la generación actual
+ * @param next buffer local para la siguiente generación
+ * @param first primera palabra global de la tesela
+ * @param words palabras de la tesela
+ * @param halo palabras de halo a cada lado, al menos block_depth_ células
+ * @return std::size_t número de bits a 1 de la tesela en la última generación
+ */
+std::size_t PackedLattice::StepTile(uint64_t* current, uint64_t* next, const std::size_t& first,
+                                    const std::size_t& words, const std::size_t& halo) {
+  const long origin = static_cast<long>(first) - static_cast<long>(halo) - 1;
+  for (std::size_t w = 1; w <= words + 2 * halo; ++w) {
+    current[w] = TileWord(origin + static_cast<long>(w));
+  }
+  const bool left = borderType_ != PERIODIC && first == 0;
+  const bool right = borderType_ != PERIODIC && first + words == words_;
+  std::size_t population = 0;
+  for (long generation = 1; generation <= block_depth_; ++generation) {
+    if (left || right) {
+      SetTileBorders(current, origin, left, right);
+    }
+    const std::size_t margin = (block_depth_ - generation + 63) / 64;
+    population = StepRange(current, next, halo + 1 - margin, halo + 1 + words + margin);
+    std::swap(current, next);
+  }
+  // Tras el último intercambio, current tiene la última generación
+  std::memcpy(next_.data() + kPadWords + first, current + halo + 1, words * sizeof(uint64_t));
+  return population;
+}
+
+/**
+ * @brief Método que devuelve las 64 células que empiezan en la célula 64 * word.
+ * Dentro del retículo es la propia palabra. Con frontera periódica, las células de fuera (o los bits
+ * sobrantes de la última palabra) se toman del otro extremo, célula a célula; solo pasa en las teselas
+ * de los extremos. Con las otras fronteras lo de fuera da igual, porque SetTileBorders coloca la
+ * célula frontera en cada generación, y se devuelve 0.
+ * @param word palabra, negativa o mayor que la última si cae en el halo
+ * @return uint64_t estado de las 64 células
+ */
+uint64_t PackedLattice::TileWord(const long& word) const {
+  const long cell = word * 64;
+  if (cell >= 0 && cell + 64 <= size_) {
+    return current_[kPadWords + word];
+  }
+  if (borderType_ != PERIODIC) {
+    return word >= 0 && word < static_cast<long>(words_) ? current_[kPadWords + word] : 0;
+  }
+  uint64_t value = 0;
+  for (int bit = 0; bit < 64; ++bit) {
+    const long position = ((cell + bit) % size_ + size_) % size_;
+    value |= static_cast<uint64_t>(getState(position)) << bit;
+  }
+  return value;
+}
+
+/**
+ * @brief Método que coloca las células frontera en una tesela local.
+ * Igual que UpdateBorders, pero con los estados de la tesela: la célula -1 y la célula size.
+ * También sirve para la ventana del cono de luz de StateAt.
+ * @param tile buffer local de la tesela
+ * @param origin palabra global que corresponde a la palabra local 0
+ * @param left si la tesela contiene el extremo izquierdo
+ * @param right si la tesela contiene el extremo derecho
+ */
+void PackedLattice::SetTileBorders(uint64_t* tile, const long& origin, const bool& left, const bool& right) const {
+  // La célula p está en el bit p % 64 de la palabra local p / 64 - origin (la célula -1, en el bit 63
+  // de la palabra -1 - origin)
+  const auto set = [tile](const long& word, const int& bit, const State& state) {
+    tile[word] = (tile[word] & ~(1ULL << bit)) | (static_cast<uint64_t>(state) << bit);
+  };
+  if (left) {
+    const State state = borderType_ == REFLECTIVE ? static_cast<State>(tile[-origin] & 1ULL) : openState_;
+    set(-1 - origin, 63, state);
+  }
+  if (right) {
+    const long last = (size_ - 1) / 64 - origin;
+    const State state = borderType_ == REFLECTIVE ? static_cast<State>((tile[last] >> ((size_ - 1) % 64)) & 1ULL) : openState_;
+    set(size_ / 64 - origin, size_ % 64, state);
+  }
+}
+
+/**
+ * @brief Método que calcula las palabras [begin, end) de la siguiente generación.
+ * Primero se calcula con la versión SIMD todo lo que cabe en vectores completos y las palabras
+ * que quedan se terminan con la versión escalar.
+ * Las reglas más usadas (30, 90, 110 y 184) tienen un núcleo especializado en tiempo de compilación,
+ * el resto usa el núcleo genérico de tabla. En ambos casos el bucle no tiene saltos por célula.
+ * @param current palabras de la generación actual
+ * @param next palabras de la siguiente generación
+ * @param begin primera palabra
+ * @param end palabra siguiente a la última
+ * @return std::size_t número de bits a 1 de las palabras calculadas
+ */
+std::size_t PackedLattice::StepRange(const uint64_t* current, uint64_t* next, std::size_t begin,
+                                     const std::size_t& end) const {
+  std::size_t population = 0;
+  if (simd_step_ != nullptr) {
+    begin = simd_step_(current, next, begin, end, rule_.getCode(), population);
+  }
+  switch (rule_.getCode()) {
+    case 30:
+      return population + Step(RuleKernel<30>(), current, next, begin, end);
+    case 90:
+      return population + Step(RuleKernel<90>(), current, next, begin, end);
+    case 110:
+      return population + Step(RuleKernel<110>(), current, next, begin, end);
+    case 184:
+      return population + Step(RuleKernel<184>(), current, next, begin, end);
+    default:
+      return population + Step(TableKernel(rule_.getCode()), current, next, begin, end);
+  }
+}
+
+/**
+ * @brief Método que calcula las palabras [begin, end) de la siguiente generación y suma su parte del hash.
+ * Se calculan de kHashWords en kHashWords para leerlas para el hash mientras siguen en la caché. La
+ * última palabra útil no se incluye: aún tiene bits que no son células, y la suma FinishGeneration.
+ * @param current palabras de la generación actual
+ * @param next palabras de la siguiente generación
+ * @param begin primera palabra
+ * @param end palabra siguiente a la última
+ * @param hash hash al que se suma la parte de las palabras calculadas
+ * @return std::size_t número de bits a 1 de las palabras calculadas
+ */
+std::size_t PackedLattice::StepRange(const uint64_t* current, uint64_t* next, std::size_t begin,
+                                     const std::size_t& end, StateHash& hash) const {
+  const std::size_t last = kPadWords + words_ - 1;
+  std::size_t population = 0;
+  for (; begin < end; begin += kHashWords) {
+    const std::size_t block_end = std::min(begin + kHashWords, end);
+    population += StepRange(current, next, begin, block_end);
+    const std::size_t hashed_end = std::min(block_end, last);
+    if (begin < hashed_end) {
+      hash += HashWords(next + begin, hashed_end - begin, begin - kPadWords);
+    }
+  }
+  return population;
+}
+
+/**
+ * @brief Método que calcula palabras de la siguiente generación con el núcleo dado.
+ * Para cada palabra se construyen las palabras de vecinos izquierdos y derechos desplazando un bit
+ * y arrastrando el bit de la palabra contigua. Con ellas se aplica la regla a las 64 células a la vez.
+ * El resultado se escribe en el otro buffer y se cuentan sus bits a 1.
+ * @param kernel núcleo que aplica la regla a palabras completas
+ * @param current palabras de la generación actual
+ * @param next palabras de la siguiente generación
+ * @param begin primera palabra
+ * @param end palabra siguiente a la última
+ * @return std::size_t número de bits a 1 de las palabras calculadas
+ */
+template <typename Kernel>
+std::size_t PackedLattice::Step(const Kernel& kernel, const uint64_t* current, uint64_t* next,
+                                const std::size_t& begin, const std::size_t& end) const {
+  std::size_t population = 0;
+  for (std::size_t k = begin; k < end; ++k) {
+    const uint64_t center = current[k];
+    const uint64_t left = (center << 1) | (current[k - 1] >> 63);
+    const uint64_t right = (center >> 1) | (current[k + 1] << 63);
+    next[k] = kernel(left, center, right);
+    population += __builtin_popcountll(next[k]);
+  }
+  return population;
+}
+
+/**
+ * @brief Método que cierra una generación una vez calculadas todas las palabras.
+ * Los bits que sobran de la última palabra no son células: se quitan de la población y se limpian.
+ * Después se intercambian los buffers y se guarda la población (y la densidad si se pide).
+ * Si se buscan ciclos, se guarda el hash de la nueva generación. Si ya se ha calculado junto con las
+ * palabras, solo falta sumar la parte de la última, que ya no tiene bits sobrantes.
+ * @param population número de bits a 1 de todas las palabras calculadas
+ * @param generations generaciones que se han avanzado (más de una en los saltos, que no se guardan
+ * en el historial de ciclos)
+ * @param hash hash de todas las palabras salvo la última, nullptr si no se ha calculado
+ */
+void PackedLattice::FinishGeneration(std::size_t population, const long& generations, const StateHash* hash) {
+  uint64_t& last = next_[kPadWords + words_ - 1];
+  population -= __builtin_popcountll(last & ~tail_mask_);
+  last &= tail_mask_;
+  current_.swap(next_);
+  population_ = population;
+  if (record_density_) {
+    density_.push_back(static_cast<double>(population_) / size_);
+  }
+  generation_ += generations;
+  if (detect_cycles_ && generations == 1 && cycles_.Searching()) {
+    if (hash == nullptr) {
+      cycles_.Record(Hash(), generation_);
+    } else {
+      StateHash state = *hash;
+      state += HashWords(current_.data() + kPadWords + words_ - 1, 1, words_ - 1);
+      cycles_.Record(state, generation_);
+    }
+  }
+}
+
+/**
+ * @brief Método que activa o desactiva la detección de ciclos.
+ * El historial empieza con la generación actual.
+ * @param detect si se guarda el hash de cada generación
+ */
+void PackedLattice::setCycleDetection(const bool& detect) {
+  detect_cycles_ = detect;
+  cycles_.Reset();
+  if (detect_cycles_) {
+    cycles_.Record(Hash(), generation_);
+  }
+}
+
+/**
+ * @brief Método que salta a cualquier generación a partir del inicio del ciclo.
+ * Como a partir del transitorio el estado se repite cada periodo generaciones, la generación pedida
+ * tiene el mismo estado que la que está (generación - actual) módulo periodo generaciones por delante,
+ * así que como mucho se evoluciona un periodo.
+ * @param generation generación a la que se salta, mayor o igual que el transitorio
+ * @return true si se ha saltado, false si aún no se ha detectado el ciclo o la generación es anterior
+ */
+bool PackedLattice::FastForward(const long& generation) {
+  if (!cycles_.Found() || generation < cycles_.getTransient()) {
+    return false;
+  }
+  const long period = cycles_.getPeriod();
+  Evolve(((generation - generation_) % period + period) % period);
+  generation_ = generation;
+  return true;
+}
+
+/**
+ * @brief Método que devuelve el estado de una célula en una generación futura sin tocar el retículo.
+ * La célula en la generación actual + T solo depende de las 2T + 1 células que la rodean ahora (su
+ * cono de luz), así que se copian a una ventana local y se evoluciona solo esa ventana, que se
+ * estrecha una célula por lado en cada generación. Son O(T^2 / 64) operaciones con palabras, sin
+ * importar el tamaño del retículo. Los extremos se tratan igual que en las teselas de StepTile.
+ * @param position posición de la célula, entre 0 y size - 1
+ * @param generation generación pedida, mayor o igual que la actual
+ * @return State estado de la célula en esa generación
+ */
+State PackedLattice::StateAt(const Position& position, const long& generation) const {
+  const long depth = generation - generation_;
+  if (position < 0 || position >= size_ || depth < 0) {
+    std::cerr << "Cell " << position << " at generation " << generation << " is outside the lattice or in the past." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  // Palabra que contiene una célula, también para células negativas
+  const auto word_of = [](const long& cell) { return cell >= 0 ? cell / 64 : -((63 - cell) / 64); };
+  long first = word_of(position - depth), last = word_of(position + depth);
+  // Sin frontera periódica, la ventana no pasa de las células frontera
+  if (borderType_ != PERIODIC) {
+    first = std::max(first, -1L);
+    last = std::min(last, static_cast<long>(size_ / 64));
+  }
+  // Una palabra de relleno a cada lado: la palabra local w es la global origin + w
+  const long origin = first - 1;
+  const std::size_t words = last - first + 1;
+  std::vector<uint64_t> current(words + 2, 0);
+  std::vector<uint64_t> next(words + 2, 0);
+  for (std::size_t w = 1; w <= words; ++w) {
+    current[w] = TileWord(origin + static_cast<long>(w));
+  }
+  const bool left = borderType_ != PERIODIC && position - depth < 0;
+  const bool right = borderType_ != PERIODIC && position + depth >= size_;
+  for (long step = 1; step <= depth; ++step) {
+    if (left || right) {
+      SetTileBorders(current.data(), origin, left, right);
+    }
+    // Solo hace falta lo que está a depth - step células o menos de la célula pedida
+    const long reach = depth - step;
+    const long begin = std::max(word_of(position - reach) - origin, 1L);
+    const long end = std::min(word_of(position + reach) - origin + 1, static_cast<long>(words) + 1);
+    StepRange(current.data(), next.data(), begin, end);
+    current.swap(next);
+  }
+  return (current[position / 64 - origin] >> (position % 64)) & 1ULL;
+}
+
+/**
+ * @brief Método que analiza la propagación del daño sin tocar el retículo.
+ * Se evoluciona a la vez una copia del retículo y un gemelo igual salvo en la célula flip, y en cada
+ * generación se cuentan las células distintas (el XOR de los dos) y dónde están la primera y la última.
+ * El daño avanza como mucho una célula por lado y generación, y para calcularlo solo hace falta el
+ * retículo una célula más allá, así que basta con el cono de luz de 2 * generations + 1 células
+ * alrededor de flip: se evoluciona esa ventana estrechándola como en StateAt, sea cual sea el tamaño
+ * del retículo. Con frontera periódica las posiciones de la ventana no se reducen módulo size; si la
+ * ventana da la vuelta al anillo, el daño podría encontrarse consigo mismo y se evoluciona el anillo
+ * completo. En los dos casos el frente se da como desplazamiento desde flip, entre -step y step, así
+ * que no depende de cuál de los dos se use.
+ * Las dos copias se calculan en la misma pasada (ver StepTwin). Si el daño desaparece, los dos
+ * gemelos ya son iguales para siempre y se termina antes.
+ * @param flip posición de la célula que se cambia, entre 0 y size - 1
+ * @param generations número de generaciones
+ * @return std::vector<Damage> diferencia de cada generación, desde la actual (una sola célula)
+ */
+std::vector<Damage> PackedLattice::SpreadDamage(const Position& flip, const long& generations) const {
+  if (flip < 0 || flip >= size_ || generations < 0) {
+    std::cerr << "Cell " << flip << " is outside the lattice or the number of generations is negative." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  const auto word_of = [](const long& cell) { return cell >= 0 ? cell / 64 : -((63 - cell) / 64); };
+  const long reach = 2 * generations + 1;
+  long first = word_of(flip - reach), last = word_of(flip + reach);
+  if (borderType_ != PERIODIC) {
+    first = std::max(first, -1L);
+    last = std::min(last, static_cast<long>(size_ / 64));
+  }
+  const bool ring = borderType_ == PERIODIC && (last - first + 1) * 64 >= size_;
+  if (ring) {
+    first = 0;
+    last = static_cast<long>(words_) - 1;
+  }
+  // Una palabra de relleno a cada lado: la palabra local w es la global origin + w
+  const long origin = first - 1;
+  const std::size_t words = last - first + 1;
+  std::vector<uint64_t> base(words + 2, 0);
+  for (std::size_t w = 1; w <= words; ++w) {
+    base[w] = TileWord(origin + static_cast<long>(w));
+  }
+  std::vector<uint64_t> twin = base;
+  twin[flip / 64 - origin] ^= 1ULL << (flip % 64);
+  std::vector<uint64_t> base_next(words + 2, 0);
+  std::vector<uint64_t> twin_next(words + 2, 0);
+  TwinPass pass{};
+  if (borderType_ == PERIODIC && !ring) {
+    pass.valid_first = 0;
+    pass.valid_last = words + 1;
+    pass.tail = ~0ULL;
+  } else {
+    pass.valid_first = std::max(-origin, 0L);
+    pass.valid_last = (size_ - 1) / 64 - origin;
+    pass.tail = tail_mask_;
+  }
+  // En el anillo, la célula -1 es la size - 1 y la célula size es la 0, de cada gemelo
+  const auto set_ring_borders = [this](uint64_t* words) {
+    const auto set = [words](const long& word, const int& bit, const uint64_t& state) {
+      words[word] = (words[word] & ~(1ULL << bit)) | (state << bit);
+    };
+    set(0, 63, (words[1 + (size_ - 1) / 64] >> ((size_ - 1) % 64)) & 1ULL);
+    set(1 + size_ / 64, size_ % 64, words[1] & 1ULL);
+  };
+  // Bits distintos de una palabra que son células del retículo
+  const auto difference = [&](const std::size_t& k) {
+    return (base[k] ^ twin[k]) & (k == pass.valid_last ? pass.tail : ~0ULL);
+  };
+  // En el anillo, células que hay desde cell hasta la primera distinta avanzando en sentido direction
+  const auto ring_distance = [&](const long& cell, const int& direction) {
+    const long start = (cell % static_cast<long>(size_) + size_) % size_;
+    std::size_t k = start / 64;
+    uint64_t bits = difference(1 + k) & (direction > 0 ? ~0ULL << (start % 64) : ~0ULL >> (63 - start % 64));
+    while (bits == 0) {
+      k = (k + (direction > 0 ? 1 : words - 1)) % words;
+      bits = difference(1 + k);
+    }
+    const long found = static_cast<long>(k) * 64 + (direction > 0 ? __builtin_ctzll(bits) : 63 - __builtin_clzll(bits));
+    return ((found - start) * direction + static_cast<long>(size_)) % static_cast<long>(size_);
+  };
+  const bool left = borderType_ != PERIODIC && flip - reach < 0;
+  const bool right = borderType_ != PERIODIC && flip + reach >= size_;
+  std::vector<Damage> damage;
+  damage.reserve(generations + 1);
+  damage.push_back({1, 0, 0});
+  for (long step = 1; step <= generations; ++step) {
+    if (ring) {
+      set_ring_borders(base.data());
+      set_ring_borders(twin.data());
+      pass.begin = 1;
+      pass.end = words + 1;
+    } else {
+      if (left || right) {
+        SetTileBorders(base.data(), origin, left, right);
+        SetTileBorders(twin.data(), origin, left, right);
+      }
+      const long remaining = reach - step;
+      pass.begin = std::max(word_of(flip - remaining) - origin, 1L);
+      pass.end = std::min(word_of(flip + remaining) - origin + 1, static_cast<long>(words) + 1);
+    }
+    StepTwinRange(base.data(), twin.data(), base_next.data(), twin_next.data(), pass);
+    base.swap(base_next);
+    twin.swap(twin_next);
+    if (pass.distance == 0) {
+      damage.resize(generations + 1, Damage{0, 0, 0});
+      break;
+    }
+    if (ring) {
+      // El frente es la primera y la última célula distinta a step células o menos de flip, contando
+      // hacia la derecha desde flip - step y hacia la izquierda desde flip + step
+      damage.push_back({pass.distance, -step + ring_distance(flip - step, 1), step - ring_distance(flip + step, -1)});
+    } else {
+      damage.push_back({pass.distance, (origin + static_cast<long>(pass.first)) * 64 + __builtin_ctzll(difference(pass.first)) - flip,
+                        (origin + static_cast<long>(pass.last)) * 64 + 63 - __builtin_clzll(difference(pass.last)) - flip});
+    }
+  }
+  return damage;
+}
+
+/**
+ * @brief Método que calcula las palabras [pass.begin, pass.end) de los dos gemelos.
+ * Igual que StepRange, con un núcleo especializado para las reglas más usadas y el de tabla para el resto.
+ * @param base palabras de la generación actual del retículo
+ * @param twin palabras de la generación actual del gemelo
+ * @param base_next palabras de la siguiente generación del retículo
+ * @param twin_next palabras de la siguiente generación del gemelo
+ * @param pass rango de palabras y diferencias encontradas
+ */
+void PackedLattice::StepTwinRange(const uint64_t* base, const uint64_t* twin, uint64_t* base_next,
+                                  uint64_t* twin_next, TwinPass& pass) const {
+  switch (rule_.getCode()) {
+    case 30:
+      return StepTwin(RuleKernel<30>(), base, twin, base_next, twin_next, pass);
+    case 90:
+      return StepTwin(RuleKernel<90>(), base, twin, base_next, twin_next, pass);
+    case 110:
+      return StepTwin(RuleKernel<110>(), base, twin, base_next, twin_next, pass);
+    case 184:
+      return StepTwin(RuleKernel<184>(), base, twin, base_next, twin_next, pass);
+    default:
+      return StepTwin(TableKernel(rule_.getCode()), base, twin, base_next, twin_next, pass);
+  }
+}
+
+/**
+ * @brief Método que calcula palabras de los dos gemelos con el núcleo dado.
+ * Cada vuelta lee la palabra de los dos gemelos, aplica la regla a las dos y hace el XOR de los
+ * resultados, así que el daño se mide sin volver a recorrer las palabras. Casi todas las palabras son
+ * iguales en los dos gemelos, por lo que la comprobación de las que tienen bits distintos casi nunca
+ * se hace. Los bits fuera del retículo (la célula frontera y los que sobran de la última palabra) no
+ * se cuentan.
+ * @param kernel núcleo que aplica la regla a palabras completas
+ * @param base palabras de la generación actual del retículo
+ * @param twin palabras de la generación actual del gemelo
+ * @param base_next palabras de la siguiente generación del retículo
+ * @param twin_next palabras de la siguiente generación del gemelo
+ * @param pass rango de palabras y diferencias encontradas
+ */
+template <typename Kernel>
+void PackedLattice::StepTwin(const Kernel& kernel, const uint64_t* base, const uint64_t* twin, uint64_t* base_next,
+                             uint64_t* twin_next, TwinPass& pass) const {
+  // Copias locales: las escrituras en las palabras podrían apuntar a pass para el compilador
+  const std::size_t end = pass.end, valid_first = pass.valid_first, valid_last = pass.valid_last;
+  const uint64_t tail = pass.tail;
+  std::size_t distance = 0, first = 0, last = 0;
+  for (std::size_t k = pass.begin; k < end; ++k) {
+    const uint64_t center = base[k];
+    base_next[k] = kernel((center << 1) | (base[k - 1] >> 63), center, (center >> 1) | (base[k + 1] << 63));
+    const uint64_t twin_center = twin[k];
+    twin_next[k] = kernel((twin_center << 1) | (twin[k - 1] >> 63), twin_center, (twin_center >> 1) | (twin[k + 1] << 63));
+    uint64_t difference = base_next[k] ^ twin_next[k];
+    if (difference != 0 && k >= valid_first && k <= valid_last) {
+      difference &= k == valid_last ? tail : ~0ULL;
+      if (difference != 0) {
+        first = distance == 0 ? k : first;
+        last = k;
+        distance += __builtin_popcountll(difference);
+      }
+    }
+  }
+  pass.distance = distance;
+  pass.first = first;
+  pass.last = last;
+}
+
+/**
+ * @brief Método que devuelve el hash de 128 bits del estado actual.
+ * Los bits sobrantes de la última palabra (donde puede estar la frontera derecha) no cuentan, así que
+ * estados iguales dan el mismo hash.
+ * @return StateHash hash de las palabras útiles
+ */
+StateHash PackedLattice::Hash() const {
+  StateHash hash = HashWords(current_.data() + kPadWords, words_ - 1);
+  const uint64_t last = current_[kPadWords + words_ - 1] & tail_mask_;
+  hash += HashWords(&last, 1, words_ - 1);
+  return hash;
+}
+
+/**
+ * @brief Método que escribe la generación actual con un bit por célula.
+ * Las palabras ya tienen la célula i en el bit i % 8 del byte i / 8 (el procesador es little-endian),
+ * así que basta con copiar los bytes. Si se pide la primera célula en el bit más significativo, como
+ * en PBM, se invierten los bits de cada byte con tres intercambios sobre la palabra completa.
+ * Los bits que sobran del último byte se dejan a 0: con varios hilos la célula frontera derecha ya
+ * está colocada tras la última célula y no debe salir en la fila.
+ * @param row destino, con sitio para (size + 7) / 8 bytes
+ * @param msb_first si la primera célula de cada byte va en el bit más significativo
+ */
+void PackedLattice::PackRow(uint8_t* row, const bool& msb_first) const {
+  const std::size_t bytes = (size_ + 7) / 8;
+  if (!msb_first) {
+    std::memcpy(row, current_.data() + kPadWords, bytes);
+    if (size_ % 8 != 0) {
+      row[bytes - 1] &= (1U << (size_ % 8)) - 1;
+    }
+    return;
+  }
+  for (std::size_t k = 0; k < words_; ++k) {
+    uint64_t word = current_[kPadWords + k] & (k + 1 == words_ ? tail_mask_ : ~0ULL);
+    word = ((word >> 1) & 0x5555555555555555ULL) | ((word & 0x5555555555555555ULL) << 1);
+    word = ((word >> 2) & 0x3333333333333333ULL) | ((word & 0x3333333333333333ULL) << 2);
+    word = ((word >> 4) & 0x0f0f0f0f0f0f0f0fULL) | ((word & 0x0f0f0f0f0f0f0f0fULL) << 4);
+    std::memcpy(row + k * 8, &word, std::min<std::size_t>(8, bytes - k * 8));
+  }
+}
+
+/**
+ * @brief Método que carga una generación con un bit por célula, al revés que PackRow.
+ * Se copian los bytes sobre las palabras y se vuelve a contar la población.
+ * @param row origen, (size + 7) / 8 bytes con la primera célula de cada byte en el bit menos significativo
+ * @param generation generación que se carga
+ */
+void PackedLattice::LoadRow(const uint8_t* row, const long& generation) {
+  current_[kPadWords + words_ - 1] = 0;
+  std::memcpy(current_.data() + kPadWords, row, (static_cast<std::size_t>(size_) + 7) / 8);
+  current_[kPadWords + words_ - 1] &= tail_mask_;
+  population_ = 0;
+  for (std::size_t k = kPadWords; k < kPadWords + words_; ++k) {
+    population_ += __builtin_popcountll(current_[k]);
+  }
+  generation_ = generation;
+}
+
+/**
+ * @brief Sobre carga del operador de inserción
+ * Imprime el retículo igual que Lattice, pero construye la línea completa antes de escribirla.
+ * @param os flujo de salida
+ * @param lattice retículo a imprimir
+ * @return std::ostream& flujo de salida
+ */
+std::ostream& operator<<(std::ostream& os, const PackedLattice& lattice) {
+  std::string line(lattice.getSize(), ' ');
+  for (int i = 0; i < lattice.getSize(); ++i) {
+    if (lattice.getState(i) == ALIVE) {
+      line[i] = 'X';
+    }
+  }
+  os << line << '\n';
+  return os;
+}
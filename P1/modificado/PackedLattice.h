@@ -0,0 +1,193 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file PackedLattice.h
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Creación de la clase Retículo empaquetado.
+ * Es una alternativa a la clase Lattice pensada para retículos muy grandes. En lugar de guardar
+ * un objeto Cell por cada posición, el estado de las células se guarda como bits dentro de palabras
+ * de 64 bits (64 células por palabra). La regla se aplica a palabras completas con desplazamientos
+ * y operaciones lógicas, de forma que se calculan 64 células a la vez y se usa 1 bit por célula.
+ * La regla puede ser cualquiera de las 256 reglas elementales (ver Rule.h).
+ * Si el procesador lo permite, el paso se hace con instrucciones vectoriales (ver RuleSimd.h).
+ * Admite los mismos tipos de frontera que Lattice (periódica, reflectora y abierta).
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifndef PACKEDLATTICE_H
+#define PACKEDLATTICE_H
+
+#include "BinaryConfig.h"
+#include "CycleDetector.h"
+#include "Lattice.h"
+#include "MacroCell.h"
+#include "Rule.h"
+#include "RuleSimd.h"
+#include "ThreadPool.h"
+
+/**
+ * @brief Diferencia entre el retículo y su gemelo con una célula cambiada en una generación
+ */
+struct Damage {
+  std::size_t distance; // número de células distintas (distancia de Hamming)
+  long left; // primera célula distinta, desde la célula cambiada; sin sentido si la distancia es 0
+  long right; // última célula distinta, desde la célula cambiada; sin sentido si la distancia es 0
+};
+
+/**
+ * @brief Clase Retículo empaquetado
+ * La célula i se guarda en el bit (i % 64) de la palabra (i / 64). Alrededor de las palabras útiles
+ * se reservan palabras de relleno, donde viven las células frontera: la posición -1 (último bit de la
+ * palabra anterior a la primera) y la posición size (bit siguiente a la última célula).
+ * Se usan dos buffers que se intercambian en cada generación, por lo que no hace falta una segunda
+ * pasada para actualizar los estados.
+ * La población se calcula en la misma pasada que la regla, sumando los bits a 1 de cada palabra nueva,
+ * así que consultarla no necesita recorrer el retículo.
+ * Con varios hilos, cada uno calcula un trozo contiguo del retículo (ver Evolve).
+ * Con bloqueo temporal, el retículo se recorre por teselas que caben en la caché y cada una avanza
+ * varias generaciones antes de volver a memoria (ver BlockStep).
+ */
+class PackedLattice {
+ public:
+  // Constructor para cuando no hay archivo de configuración inicial, solo la célula central viva
+  PackedLattice(const int& size, const BorderType& borderType, const State& openState, const int& rule);
+  // Constructor que lee la configuración inicial desde un archivo
+  PackedLattice(const int size, const BorderType& borderType, const State& openState, const int& rule,
+                const std::string& file_name);
+  // Constructor que copia la configuración binaria proyectada en memoria, sin interpretar texto
+  explicit PackedLattice(const BinaryConfig& config);
+  // Getters de la clase
+  int getSize() const { return size_; }
+  const Rule& getRule() const { return rule_; }
+  BorderType getBorderType() const { return borderType_; }
+  State getOpenState() const { return openState_; }
+  // setter del nivel SIMD con el que se calcula cada generación
+  void setSimdLevel(const SimdLevel& level) { simd_step_ = GetSimdStep(level); }
+  // método que devuelve el estado de la célula en la posición dada
+  State getState(const Position&) const;
+  // método modificador para poder establecer la configuración inicial
+  void setState(const Position&, const State&);
+  // método que pone cada célula viva al azar con la probabilidad dada, igual con cualquier número de hilos
+  void Randomize(const double& density, const uint64_t& seed);
+  // setter del número de hilos con los que se evoluciona el retículo
+  void setThreads(const std::size_t&);
+  // setter del salto del motor de macro-células (2^log_step generaciones), -1 para no usarlo
+  void setJump(const int& log_step);
+  // setter de las generaciones que avanza cada tesela con bloqueo temporal, 0 o 1 para no usarlo
+  void setTemporalBlocking(const int& depth) { block_depth_ = depth; }
+  // método que evoluciona el autómata celular
+  void NextGeneration();
+  // método que evoluciona el autómata celular varias generaciones seguidas
+  void Evolve(const long&);
+  // Metodo que devuelve el numero de celulas vivas, sin recorrer el retículo
+  std::size_t CountAliveCells() const { return population_; }
+  // método que activa o desactiva la serie temporal de densidad (células vivas / tamaño)
+  void setRecordDensity(const bool&);
+  // Getter de la serie temporal de densidad, un valor por generación
+  const std::vector<double>& getDensity() const { return density_; }
+  // Getter de la generación actual (0 es la configuración inicial)
+  long getGeneration() const { return generation_; }
+  // método que activa o desactiva la detección de ciclos, empezando por la generación actual
+  void setCycleDetection(const bool&);
+  // Getter del detector de ciclos, con el transitorio y el periodo si ya se han detectado
+  const CycleDetector& getCycles() const { return cycles_; }
+  // método que salta a cualquier generación del ciclo ya detectado; false si no se puede
+  bool FastForward(const long& generation);
+  // método que devuelve el estado de una célula en una generación futura evolucionando solo su cono de luz
+  State StateAt(const Position& position, const long& generation) const;
+  // método que evoluciona un gemelo con una célula cambiada y devuelve la diferencia de cada generación
+  std::vector<Damage> SpreadDamage(const Position& flip, const long& generations) const;
+  // método que devuelve el hash de 128 bits del estado actual
+  StateHash Hash() const;
+  // método que escribe la generación actual con un bit por célula, (size + 7) / 8 bytes
+  void PackRow(uint8_t* row, const bool& msb_first) const;
+  // método que carga una generación escrita por PackRow (primera célula en el bit menos significativo)
+  void LoadRow(const uint8_t* row, const long& generation);
+  // método que imprime el estado del retículo
+  friend std::ostream& operator<<(std::ostream&, const PackedLattice&);
+
+ private:
+  // Palabras de relleno a cada lado de las palabras útiles
+  static constexpr std::size_t kPadWords = 8;
+  // Palabras de cada tesela del bloqueo temporal (16 KiB por buffer, las dos caben en la caché L1/L2)
+  static constexpr std::size_t kTileWords = 2048;
+  // Palabras que se calculan antes de sumar su parte del hash, mientras siguen en la caché L1
+  static constexpr std::size_t kHashWords = 512;
+  /**
+   * @brief Pasada de la propagación del daño: palabras que se calculan, palabras que tienen células
+   * del retículo y diferencias encontradas entre las dos palabras nuevas
+   */
+  struct TwinPass {
+    std::size_t begin; // primera palabra que se calcula
+    std::size_t end; // palabra siguiente a la última que se calcula
+    std::size_t valid_first; // primera palabra con células del retículo
+    std::size_t valid_last; // última palabra con células del retículo
+    uint64_t tail; // bits de la palabra valid_last que son células del retículo
+    std::size_t distance; // número de bits distintos
+    std::size_t first; // primera palabra con bits distintos
+    std::size_t last; // última palabra con bits distintos
+  };
+  // método que coloca las células frontera según el tipo de frontera
+  void UpdateBorders();
+  // método que calcula un rango de palabras de la siguiente generación
+  std::size_t StepRange(const uint64_t* current, uint64_t* next, std::size_t begin, const std::size_t& end) const;
+  // método que calcula un rango de palabras de la siguiente generación y suma su parte del hash
+  std::size_t StepRange(const uint64_t* current, uint64_t* next, std::size_t begin, const std::size_t& end,
+                        StateHash& hash) const;
+  // método que calcula un rango de palabras con el núcleo de la regla
+  template <typename Kernel>
+  std::size_t Step(const Kernel& kernel, const uint64_t* current, uint64_t* next, const std::size_t& begin,
+                   const std::size_t& end) const;
+  // método que calcula un rango de palabras del retículo y de su gemelo en la misma pasada
+  void StepTwinRange(const uint64_t* base, const uint64_t* twin, uint64_t* base_next, uint64_t* twin_next,
+                     TwinPass& pass) const;
+  // método que calcula un rango de palabras de los dos gemelos con el núcleo de la regla
+  template <typename Kernel>
+  void StepTwin(const Kernel& kernel, const uint64_t* base, const uint64_t* twin, uint64_t* base_next,
+                uint64_t* twin_next, TwinPass& pass) const;
+  // método que avanza un salto completo con el motor de macro-células
+  void Jump();
+  // método que avanza block_depth_ generaciones recorriendo el retículo por teselas
+  void BlockStep();
+  // método que avanza una tesela block_depth_ generaciones en buffers locales
+  std::size_t StepTile(uint64_t* current, uint64_t* next, const std::size_t& first, const std::size_t& words,
+                       const std::size_t& halo);
+  // método que devuelve las 64 células que empiezan en la célula 64 * word, fuera del retículo incluido
+  uint64_t TileWord(const long& word) const;
+  // método que coloca en una tesela o ventana local las células frontera de los extremos que contiene
+  void SetTileBorders(uint64_t* tile, const long& origin, const bool& left, const bool& right) const;
+  // método que cierra una generación: limpia los bits sobrantes e intercambia los buffers
+  void FinishGeneration(std::size_t population, const long& generations = 1, const StateHash* hash = nullptr);
+  std::vector<uint64_t> current_; // generación actual
+  std::vector<uint64_t> next_; // siguiente generación
+  int size_; // número de células (sin contar la frontera)
+  std::size_t words_; // número de palabras útiles
+  uint64_t tail_mask_; // máscara con los bits válidos de la última palabra
+  BorderType borderType_; // tipo de frontera
+  State openState_; // estado de las células frontera si es abierta
+  Rule rule_; // regla que se aplica
+  SimdStepFunction simd_step_ = GetSimdStep(AUTO); // paso vectorial, nullptr si es escalar
+  std::size_t population_ = 0; // número de células vivas
+  bool record_density_ = false; // si se guarda la serie temporal de densidad
+  std::vector<double> density_; // densidad de cada generación
+  std::unique_ptr<ThreadPool> pool_; // hilos persistentes, nullptr si se usa solo el hilo principal
+  std::unique_ptr<MacroCellEngine> macro_cell_; // motor de saltos, nullptr si se avanza de una en una
+  long block_depth_ = 0; // generaciones por tesela del bloqueo temporal, 0 si no se usa
+  long generation_ = 0; // generación actual
+  bool detect_cycles_ = false; // si se guarda el hash de cada generación
+  CycleDetector cycles_; // historial de hashes y ciclo detectado
+};
+
+// Sobrecarga del operador de salida
+std::ostream& operator<<(std::ostream&, const PackedLattice&);
+
+#endif // PACKEDLATTICE_H
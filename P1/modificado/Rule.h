@@ -0,0 +1,131 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file Rule.h
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Reglas elementales de Wolfram.
+ * Una regla elemental se identifica con un número entre 0 y 255 (código de Wolfram). El bit
+ * (4 * L + 2 * C + R) del número es el siguiente estado de una célula cuyo vecino izquierdo es L,
+ * ella misma C y su vecino derecho R. Aquí encontramos:
+ * 1. La clase Rule, que guarda la tabla de verdad de 8 entradas y la aplica célula a célula.
+ * 2. Los núcleos RuleKernel<Code>, que aplican una regla conocida en tiempo de compilación a
+ * palabras completas (64 células a la vez). Las reglas 30, 90, 110 y 184 tienen su fórmula propia.
+ * 3. El núcleo TableKernel, que aplica cualquier regla a palabras completas sin saltos.
+ * Los núcleos son plantillas sobre el tipo de palabra, así que sirven igual para uint64_t que para
+ * los vectores de palabras de las versiones SIMD (ver RuleSimd.h).
+ */
+
+#ifndef RULE_H
+#define RULE_H
+
+#include <cstdint>
+
+/**
+ * @brief Clase Regla
+ * Guarda el código de Wolfram y su tabla de verdad de 8 entradas.
+ */
+class Rule {
+ public:
+  // Constructor que recibe el código de Wolfram de la regla (0..255)
+  explicit Rule(const int& code) : code_(code) {
+    for (int i = 0; i < 8; ++i) {
+      table_[i] = (code_ >> i) & 1;
+    }
+  }
+  // Getter del código de la regla
+  int getCode() const { return code_; }
+  // método que devuelve el siguiente estado de una célula a partir de su vecindad
+  bool Apply(const bool& left, const bool& center, const bool& right) const {
+    return table_[(left << 2) | (center << 1) | right];
+  }
+
+ private:
+  int code_; // código de Wolfram
+  bool table_[8]; // tabla de verdad, indexada por 4 * L + 2 * C + R
+};
+
+/**
+ * @brief Selector bit a bit: toma los bits de a donde s vale 1 y los de b donde vale 0.
+ * Es la base de los núcleos genéricos, ya que cualquier regla se puede escribir como
+ * un árbol de selectores sobre L, C y R cuyas hojas son los bits de la tabla de verdad.
+ */
+template <typename Word>
+inline Word Select(const Word& s, const Word& a, const Word& b) {
+  return (a & s) | (b & ~s);
+}
+
+/**
+ * @brief Núcleo genérico para una regla conocida en tiempo de compilación.
+ * Las hojas del árbol de selectores son constantes (todo ceros o todo unos), así que el
+ * compilador simplifica la expresión a las pocas operaciones que necesita la regla.
+ * @tparam Code código de Wolfram de la regla
+ */
+template <int Code>
+struct RuleKernel {
+  template <typename Word>
+  static Word Bit(const int& index) {
+    return ((Code >> index) & 1) ? ~Word{} : Word{};
+  }
+  template <typename Word>
+  Word operator()(const Word& l, const Word& c, const Word& r) const {
+    const Word c0 = Select(r, Bit<Word>(1), Bit<Word>(0));
+    const Word c1 = Select(r, Bit<Word>(3), Bit<Word>(2));
+    const Word c2 = Select(r, Bit<Word>(5), Bit<Word>(4));
+    const Word c3 = Select(r, Bit<Word>(7), Bit<Word>(6));
+    return Select(l, Select(c, c3, c2), Select(c, c1, c0));
+  }
+};
+
+// REGLA 30 --> L xor (C or R)
+template <>
+struct RuleKernel<30> {
+  template <typename Word>
+  Word operator()(const Word& l, const Word& c, const Word& r) const { return l ^ (c | r); }
+};
+
+// REGLA 90 --> L xor R
+template <>
+struct RuleKernel<90> {
+  template <typename Word>
+  Word operator()(const Word& l, const Word&, const Word& r) const { return l ^ r; }
+};
+
+// REGLA 110 --> (C xor R) or (C and not L)
+template <>
+struct RuleKernel<110> {
+  template <typename Word>
+  Word operator()(const Word& l, const Word& c, const Word& r) const { return (c ^ r) | (c & ~l); }
+};
+
+// REGLA 184 (tráfico) --> (L and not C) or (C and R)
+template <>
+struct RuleKernel<184> {
+  template <typename Word>
+  Word operator()(const Word& l, const Word& c, const Word& r) const { return (l & ~c) | (c & r); }
+};
+
+/**
+ * @brief Núcleo para cualquier regla conocida solo en tiempo de ejecución.
+ * Cada bit de la tabla de verdad se convierte en una máscara (todo ceros o todo unos) y se
+ * recorre el mismo árbol de selectores que en RuleKernel, sin ningún salto condicional.
+ */
+struct TableKernel {
+  explicit TableKernel(const int& code) {
+    for (int i = 0; i < 8; ++i) {
+      mask_[i] = ((code >> i) & 1) ? ~0ULL : 0ULL;
+    }
+  }
+  // Word puede ser uint64_t o un vector de palabras; las máscaras se replican en cada palabra
+  template <typename Word>
+  Word operator()(const Word& l, const Word& c, const Word& r) const {
+    const Word c0 = Select(r, Word{} | mask_[1], Word{} | mask_[0]);
+    const Word c1 = Select(r, Word{} | mask_[3], Word{} | mask_[2]);
+    const Word c2 = Select(r, Word{} | mask_[5], Word{} | mask_[4]);
+    const Word c3 = Select(r, Word{} | mask_[7], Word{} | mask_[6]);
+    return Select(l, Select(c, c3, c2), Select(c, c1, c0));
+  }
+  uint64_t mask_[8]; // bits de la tabla de verdad convertidos en máscaras
+};
+
+#endif // RULE_H
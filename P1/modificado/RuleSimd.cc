@@ -0,0 +1,106 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file RuleSimd.cc
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Selección de la versión SIMD del paso de PackedLattice.
+ * Aquí encontramos la detección del juego de instrucciones del procesador con CPUID y la función
+ * que devuelve la función de paso de cada nivel.
+ */
+
+#include "RuleSimd.h"
+
+/**
+ * @brief Función que devuelve el mejor nivel SIMD que admite el procesador.
+ * __builtin_cpu_supports consulta CPUID (y que el sistema operativo guarde los registros anchos).
+ * @return SimdLevel nivel más ancho disponible
+ */
+SimdLevel DetectSimdLevel() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return AVX512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return AVX2;
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    return SSE2;
+  }
+#endif
+  return SCALAR;
+}
+
+/**
+ * @brief Función que devuelve la función de paso de un nivel SIMD.
+ * Si se pide AUTO, se detecta el mejor nivel del procesador.
+ * @param level nivel SIMD
+ * @return SimdStepFunction función de paso, o nullptr si el nivel es escalar
+ */
+SimdStepFunction GetSimdStep(const SimdLevel& level) {
+  switch (level == AUTO ? DetectSimdLevel() : level) {
+    case AVX512:
+      return StepAvx512;
+    case AVX2:
+      return StepAvx2;
+    case SSE2:
+      return StepSse2;
+    default:
+      return nullptr;
+  }
+}
+
+/**
+ * @brief Función que devuelve la función de paso del conjunto de simulaciones de un nivel SIMD.
+ * Si se pide AUTO, se detecta el mejor nivel del procesador.
+ * @param level nivel SIMD
+ * @return SimdEnsembleFunction función de paso, o nullptr si el nivel es escalar
+ */
+SimdEnsembleFunction GetSimdEnsemble(const SimdLevel& level) {
+  switch (level == AUTO ? DetectSimdLevel() : level) {
+    case AVX512:
+      return EnsembleAvx512;
+    case AVX2:
+      return EnsembleAvx2;
+    case SSE2:
+      return EnsembleSse2;
+    default:
+      return nullptr;
+  }
+}
+
+/**
+ * @brief Función que devuelve la traducción de sumas de TotalisticLattice de un nivel SIMD.
+ * Si se pide AUTO, se detecta el mejor nivel del procesador. Con SSE2 se usa la versión escalar.
+ * @param level nivel SIMD
+ * @return SimdLookupFunction función de traducción, o nullptr si no hay versión vectorial
+ */
+SimdLookupFunction GetSimdLookup(const SimdLevel& level) {
+  switch (level == AUTO ? DetectSimdLevel() : level) {
+    case AVX512:
+      return LookupAvx512;
+    case AVX2:
+      return LookupAvx2;
+    default:
+      return nullptr;
+  }
+}
+
+/**
+ * @brief Función que devuelve el nombre de un nivel SIMD
+ * @param level nivel SIMD
+ * @return std::string nombre del nivel
+ */
+std::string SimdLevelName(const SimdLevel& level) {
+  switch (level == AUTO ? DetectSimdLevel() : level) {
+    case AVX512:
+      return "avx512";
+    case AVX2:
+      return "avx2";
+    case SSE2:
+      return "sse2";
+    default:
+      return "scalar";
+  }
+}
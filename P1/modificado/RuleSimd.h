@@ -0,0 +1,81 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file RuleSimd.h
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Versiones vectoriales (SIMD) del paso de PackedLattice.
+ * Cada versión aplica la regla a varias palabras de 64 células a la vez: 2 palabras con SSE2
+ * (128 células), 4 con AVX2 (256 células) y 8 con AVX-512 (512 células). Cada una se compila en su
+ * propio fichero con las opciones del juego de instrucciones correspondiente y al arrancar se elige
+ * la mejor que admite el procesador consultando CPUID.
+ */
+
+#ifndef RULESIMD_H
+#define RULESIMD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Tipo de las funciones de paso vectoriales.
+ * Aplican la regla de código code a las palabras [begin, end) de current y escriben el resultado
+ * en next. Leen también las palabras begin - 1 y end, donde están las células frontera.
+ * Solo procesan bloques completos del tamaño del vector y devuelven la primera palabra que no han
+ * calculado, para que el resto lo termine la versión escalar. Suman a population el número de bits
+ * a 1 de las palabras que escriben.
+ */
+using SimdStepFunction = std::size_t (*)(const uint64_t* current, uint64_t* next, std::size_t begin,
+                                         std::size_t end, const int& code, std::size_t& population);
+
+// Versiones de la función de paso para cada juego de instrucciones
+std::size_t StepSse2(const uint64_t*, uint64_t*, std::size_t, std::size_t, const int&, std::size_t&);
+std::size_t StepAvx2(const uint64_t*, uint64_t*, std::size_t, std::size_t, const int&, std::size_t&);
+std::size_t StepAvx512(const uint64_t*, uint64_t*, std::size_t, std::size_t, const int&, std::size_t&);
+
+/**
+ * @brief Tipo de las funciones de paso vectoriales de EnsembleLattice.
+ * Cada bit es una simulación distinta: la palabra k tiene como vecinas las palabras k - stride y
+ * k + stride. Igual que las anteriores, solo procesan bloques completos y devuelven la primera
+ * palabra que no han calculado.
+ */
+using SimdEnsembleFunction = std::size_t (*)(const uint64_t* current, uint64_t* next, std::size_t begin,
+                                             std::size_t end, std::size_t stride, const int& code);
+
+// Versiones de la función de paso del conjunto de simulaciones para cada juego de instrucciones
+std::size_t EnsembleSse2(const uint64_t*, uint64_t*, std::size_t, std::size_t, std::size_t, const int&);
+std::size_t EnsembleAvx2(const uint64_t*, uint64_t*, std::size_t, std::size_t, std::size_t, const int&);
+std::size_t EnsembleAvx512(const uint64_t*, uint64_t*, std::size_t, std::size_t, std::size_t, const int&);
+
+/**
+ * @brief Tipo de las funciones de traducción vectoriales de TotalisticLattice.
+ * Cambian cada byte de sums (entre 0 y 31) por esa entrada de table (32 bytes) y lo escriben en
+ * states, con una búsqueda de bytes en registro (vpshufb) por cada 32 bytes. Solo procesan bloques
+ * completos y devuelven el primer byte que no han traducido.
+ */
+using SimdLookupFunction = std::size_t (*)(const uint8_t* sums, uint8_t* states, std::size_t count,
+                                           const uint8_t* table);
+
+// Versiones de la traducción de sumas (SSE2 no tiene búsqueda de bytes, que llega con SSSE3)
+std::size_t LookupAvx2(const uint8_t*, uint8_t*, std::size_t, const uint8_t*);
+std::size_t LookupAvx512(const uint8_t*, uint8_t*, std::size_t, const uint8_t*);
+
+/**
+ * @brief Enumerado con los niveles SIMD disponibles, de menor a mayor anchura.
+ * AUTO indica que se elija el mejor que admita el procesador.
+ */
+enum SimdLevel { SCALAR, SSE2, AVX2, AVX512, AUTO };
+
+// Función que devuelve el mejor nivel SIMD que admite el procesador
+SimdLevel DetectSimdLevel();
+// Función que devuelve la función de paso de un nivel (nullptr para el escalar)
+SimdStepFunction GetSimdStep(const SimdLevel&);
+// Función que devuelve la función de paso del conjunto de simulaciones de un nivel (nullptr para el escalar)
+SimdEnsembleFunction GetSimdEnsemble(const SimdLevel&);
+// Función que devuelve la traducción de sumas de un nivel (nullptr para el escalar y SSE2)
+SimdLookupFunction GetSimdLookup(const SimdLevel&);
+// Función que devuelve el nombre de un nivel SIMD
+std::string SimdLevelName(const SimdLevel&);
+
+#endif // RULESIMD_H
@@ -0,0 +1,176 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file RuleSimdKernel.h
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Bucle vectorial común a todas las versiones SIMD.
+ * Se incluye desde RuleSimd_sse2.cc, RuleSimd_avx2.cc y RuleSimd_avx512.cc, cada uno con un tipo
+ * de vector distinto. Los vectores son los de la extensión de GCC (vector_size), que admiten los
+ * mismos operadores que uint64_t, así que los núcleos de Rule.h se usan sin cambios.
+ * Estos ficheros lo incluyen dentro de un espacio de nombres anónimo: así ninguna función compilada
+ * con instrucciones AVX se puede mezclar al enlazar con la versión escalar.
+ */
+
+#ifndef RULESIMDKERNEL_H
+#define RULESIMDKERNEL_H
+
+/**
+ * @brief Lee un vector de palabras desde una dirección sin alinear
+ */
+template <typename Vec>
+inline Vec LoadWords(const uint64_t* address) {
+  Vec value;
+  std::memcpy(&value, address, sizeof(Vec));
+  return value;
+}
+
+/**
+ * @brief Escribe un vector de palabras en una dirección sin alinear
+ */
+template <typename Vec>
+inline void StoreWords(uint64_t* address, const Vec& value) {
+  std::memcpy(address, &value, sizeof(Vec));
+}
+
+/**
+ * @brief Cuenta los bits a 1 de cada byte de un vector (método SWAR).
+ * Cada byte del resultado vale entre 0 y 8, así que se pueden sumar hasta 31 resultados sin desbordar.
+ */
+template <typename Vec>
+inline Vec PopcountBytes(Vec value) {
+  value = value - ((value >> 1) & 0x5555555555555555ULL);
+  value = (value & 0x3333333333333333ULL) + ((value >> 2) & 0x3333333333333333ULL);
+  return (value + (value >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+}
+
+/**
+ * @brief Suma todos los bytes de un vector de contadores por byte
+ */
+template <typename Vec>
+inline std::size_t SumBytes(Vec value) {
+  value = (value & 0x00ff00ff00ff00ffULL) + ((value >> 8) & 0x00ff00ff00ff00ffULL);
+  value = (value & 0x0000ffff0000ffffULL) + ((value >> 16) & 0x0000ffff0000ffffULL);
+  value = (value & 0x00000000ffffffffULL) + (value >> 32);
+  std::size_t sum = 0;
+  for (std::size_t lane = 0; lane < sizeof(Vec) / sizeof(uint64_t); ++lane) {
+    sum += value[lane];
+  }
+  return sum;
+}
+
+/**
+ * @brief Aplica el núcleo a bloques completos de palabras.
+ * Igual que el bucle escalar, los vecinos izquierdos se obtienen desplazando un bit y arrastrando el
+ * último bit de la palabra anterior, que se lee cargando el vector una palabra antes (y una después
+ * para los vecinos derechos). La población se acumula sin salir de los registros vectoriales: los
+ * contadores por byte se suman durante 31 bloques y después se vuelcan a population.
+ * @return std::size_t primera palabra que no se ha calculado
+ */
+template <typename Vec, typename Kernel>
+std::size_t StepWords(const uint64_t* current, uint64_t* next, std::size_t begin, std::size_t end,
+                      const Kernel& kernel, std::size_t& population) {
+  constexpr std::size_t kLanes = sizeof(Vec) / sizeof(uint64_t);
+  std::size_t k = begin;
+  Vec counts{};
+  int pending = 0;
+  for (; k + kLanes <= end; k += kLanes) {
+    const Vec center = LoadWords<Vec>(current + k);
+    const Vec left = (center << 1) | (LoadWords<Vec>(current + k - 1) >> 63);
+    const Vec right = (center >> 1) | (LoadWords<Vec>(current + k + 1) << 63);
+    const Vec value = kernel(left, center, right);
+    StoreWords(next + k, value);
+    counts += PopcountBytes(value);
+    if (++pending == 31) {
+      population += SumBytes(counts);
+      counts = Vec{};
+      pending = 0;
+    }
+  }
+  population += SumBytes(counts);
+  return k;
+}
+
+/**
+ * @brief Elige el núcleo de la regla, igual que PackedLattice::StepRange
+ * @return std::size_t primera palabra que no se ha calculado
+ */
+template <typename Vec>
+std::size_t StepRule(const uint64_t* current, uint64_t* next, std::size_t begin, std::size_t end,
+                     const int& code, std::size_t& population) {
+  switch (code) {
+    case 30:
+      return StepWords<Vec>(current, next, begin, end, RuleKernel<30>(), population);
+    case 90:
+      return StepWords<Vec>(current, next, begin, end, RuleKernel<90>(), population);
+    case 110:
+      return StepWords<Vec>(current, next, begin, end, RuleKernel<110>(), population);
+    case 184:
+      return StepWords<Vec>(current, next, begin, end, RuleKernel<184>(), population);
+    default:
+      return StepWords<Vec>(current, next, begin, end, TableKernel(code), population);
+  }
+}
+
+/**
+ * @brief Aplica el núcleo a bloques completos de palabras de un conjunto de simulaciones (EnsembleLattice).
+ * Aquí cada bit es una simulación distinta y los vecinos de una palabra son las palabras que están
+ * stride posiciones antes y después, así que no hay desplazamientos: solo operaciones lógicas.
+ * @return std::size_t primera palabra que no se ha calculado
+ */
+template <typename Vec, typename Kernel>
+std::size_t StepEnsembleWords(const uint64_t* current, uint64_t* next, std::size_t begin, std::size_t end,
+                              std::size_t stride, const Kernel& kernel) {
+  constexpr std::size_t kLanes = sizeof(Vec) / sizeof(uint64_t);
+  std::size_t k = begin;
+  for (; k + kLanes <= end; k += kLanes) {
+    const Vec left = LoadWords<Vec>(current + k - stride);
+    const Vec center = LoadWords<Vec>(current + k);
+    const Vec right = LoadWords<Vec>(current + k + stride);
+    StoreWords(next + k, kernel(left, center, right));
+  }
+  return k;
+}
+
+/**
+ * @brief Elige el núcleo de la regla para el conjunto de simulaciones
+ * @return std::size_t primera palabra que no se ha calculado
+ */
+template <typename Vec>
+std::size_t StepEnsembleRule(const uint64_t* current, uint64_t* next, std::size_t begin, std::size_t end,
+                             std::size_t stride, const int& code) {
+  switch (code) {
+    case 30:
+      return StepEnsembleWords<Vec>(current, next, begin, end, stride, RuleKernel<30>());
+    case 90:
+      return StepEnsembleWords<Vec>(current, next, begin, end, stride, RuleKernel<90>());
+    case 110:
+      return StepEnsembleWords<Vec>(current, next, begin, end, stride, RuleKernel<110>());
+    case 184:
+      return StepEnsembleWords<Vec>(current, next, begin, end, stride, RuleKernel<184>());
+    default:
+      return StepEnsembleWords<Vec>(current, next, begin, end, stride, TableKernel(code));
+  }
+}
+
+/**
+ * @brief Traduce bytes con una tabla de tantas entradas como bytes tiene el vector.
+ * __builtin_shuffle toma cada byte del índice como posición dentro del vector de la tabla; con
+ * vectores de 32 bytes y AVX2 se traduce a dos vpshufb (uno por mitad) y una mezcla.
+ * @return std::size_t primer byte que no se ha traducido
+ */
+template <typename VecBytes>
+std::size_t LookupBytes(const uint8_t* sums, uint8_t* states, std::size_t count, const uint8_t* table) {
+  VecBytes entries;
+  std::memcpy(&entries, table, sizeof(VecBytes));
+  std::size_t k = 0;
+  for (; k + sizeof(VecBytes) <= count; k += sizeof(VecBytes)) {
+    VecBytes index;
+    std::memcpy(&index, sums + k, sizeof(VecBytes));
+    const VecBytes value = __builtin_shuffle(entries, index);
+    std::memcpy(states + k, &value, sizeof(VecBytes));
+  }
+  return k;
+}
+
+#endif // RULESIMDKERNEL_H
@@ -0,0 +1,51 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file RuleSimd_avx2.cc
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Versión AVX2 del paso de PackedLattice.
+ * Se compila con las opciones de AVX2 (ver Makefile) y trabaja con vectores de 4 palabras,
+ * es decir, 256 células por operación.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "RuleSimd.h"
+
+namespace {
+#include "Rule.h"
+#include "RuleSimdKernel.h"
+
+// Vector de 4 palabras de 64 bits sin signo
+typedef uint64_t VecWords __attribute__((vector_size(32)));
+// Vector de 32 bytes sin signo
+typedef uint8_t VecBytes __attribute__((vector_size(32)));
+}  // namespace
+
+/**
+ * @brief Función de paso AVX2
+ * @return std::size_t primera palabra que no se ha calculado
+ */
+std::size_t StepAvx2(const uint64_t* current, uint64_t* next, std::size_t begin, std::size_t end, const int& code,
+                     std::size_t& population) {
+  return StepRule<VecWords>(current, next, begin, end, code, population);
+}
+
+/**
+ * @brief Función de paso AVX2 del conjunto de simulaciones
+ * @return std::size_t primera palabra que no se ha calculado
+ */
+std::size_t EnsembleAvx2(const uint64_t* current, uint64_t* next, std::size_t begin, std::size_t end,
+                         std::size_t stride, const int& code) {
+  return StepEnsembleRule<VecWords>(current, next, begin, end, stride, code);
+}
+/**
+ * @brief Función de traducción de sumas AVX2
+ * @return std::size_t primer byte que no se ha traducido
+ */
+std::size_t LookupAvx2(const uint8_t* sums, uint8_t* states, std::size_t count, const uint8_t* table) {
+  return LookupBytes<VecBytes>(sums, states, count, table);
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file RuleSimd_avx512.cc
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Versión AVX-512 del paso de PackedLattice.
+ * Se compila con las opciones de AVX-512 (ver Makefile) y trabaja con vectores de 8 palabras,
+ * es decir, 512 células por operación.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "RuleSimd.h"
+
+namespace {
+#include "Rule.h"
+#include "RuleSimdKernel.h"
+
+// Vector de 8 palabras de 64 bits sin signo
+typedef uint64_t VecWords __attribute__((vector_size(64)));
+// Vector de 32 bytes sin signo: sin AVX-512BW no hay operaciones de bytes de 512 bits
+typedef uint8_t VecBytes __attribute__((vector_size(32)));
+}  // namespace
+
+/**
+ * @brief Función de paso AVX-512
+ * @return std::size_t primera palabra que no se ha calculado
+ */
+std::size_t StepAvx512(const uint64_t* current, uint64_t* next, std::size_t begin, std::size_t end, const int& code,
+                       std::size_t& population) {
+  return StepRule<VecWords>(current, next, begin, end, code, population);
+}
+
+/**
+ * @brief Función de paso AVX-512 del conjunto de simulaciones
+ * @return std::size_t primera palabra que no se ha calculado
+ */
+std::size_t EnsembleAvx512(const uint64_t* current, uint64_t* next, std::size_t begin, std::size_t end,
+                           std::size_t stride, const int& code) {
+  return StepEnsembleRule<VecWords>(current, next, begin, end, stride, code);
+}
+/**
+ * @brief Función de traducción de sumas AVX-512 (con vectores de 32 bytes)
+ * @return std::size_t primer byte que no se ha traducido
+ */
+std::size_t LookupAvx512(const uint8_t* sums, uint8_t* states, std::size_t count, const uint8_t* table) {
+  return LookupBytes<VecBytes>(sums, states, count, table);
+}
\ No newline at end of file
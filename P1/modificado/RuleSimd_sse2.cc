@@ -0,0 +1,42 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file RuleSimd_sse2.cc
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Versión SSE2 del paso de PackedLattice.
+ * Se compila con las opciones de SSE2 (ver Makefile) y trabaja con vectores de 2 palabras,
+ * es decir, 128 células por operación.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "RuleSimd.h"
+
+namespace {
+#include "Rule.h"
+#include "RuleSimdKernel.h"
+
+// Vector de 2 palabras de 64 bits sin signo
+typedef uint64_t VecWords __attribute__((vector_size(16)));
+}  // namespace
+
+/**
+ * @brief Función de paso SSE2
+ * @return std::size_t primera palabra que no se ha calculado
+ */
+std::size_t StepSse2(const uint64_t* current, uint64_t* next, std::size_t begin, std::size_t end, const int& code,
+                     std::size_t& population) {
+  return StepRule<VecWords>(current, next, begin, end, code, population);
+}
+
+/**
+ * @brief Función de paso SSE2 del conjunto de simulaciones
+ * @return std::size_t primera palabra que no se ha calculado
+ */
+std::size_t EnsembleSse2(const uint64_t* current, uint64_t* next, std::size_t begin, std::size_t end,
+                         std::size_t stride, const int& code) {
+  return StepEnsembleRule<VecWords>(current, next, begin, end, stride, code);
+}
\ No newline at end of file
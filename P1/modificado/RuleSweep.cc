@@ -0,0 +1,140 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file RuleSweep.cc
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Implementación de los métodos de la clase RuleSweep.
+ * Encontramos el reparto de las reglas entre los hilos, la evolución de cada regla con el cálculo de
+ * sus estadísticas y el guardado del CSV.
+ */
+
+#include "RuleSweep.h"
+
+/**
+ * @brief Construct a new RuleSweep:: RuleSweep object
+ * @param lattice retículo empaquetado con la configuración inicial y la frontera (su regla no se usa)
+ * @param generations generaciones que se evoluciona cada regla
+ */
+RuleSweep::RuleSweep(const PackedLattice& lattice, const long& generations)
+    : row_((static_cast<std::size_t>(lattice.getSize()) + 7) / 8), size_(lattice.getSize()),
+      borderType_(lattice.getBorderType()), openState_(lattice.getOpenState()), generations_(generations) {
+  lattice.PackRow(row_.data(), false);
+}
+
+/**
+ * @brief Método que evoluciona todas las reglas.
+ * Cada regla es una tarea de las colas de trabajo; cada hilo va sacando tareas (propias o robadas)
+ * hasta que no queda ninguna. Cada tarea escribe solo en su posición de las estadísticas.
+ * @param rules reglas que se evolucionan
+ * @param threads número de hilos
+ */
+void RuleSweep::Run(const std::vector<int>& rules, const std::size_t& threads) {
+  stats_.assign(rules.size(), RuleStats());
+  ThreadPool pool(threads);
+  WorkQueues queues(threads, rules.size());
+  pool.Run([&](std::size_t id) {
+    std::size_t task;
+    while (queues.Pop(id, task)) {
+      stats_[task] = Measure(rules[task]);
+    }
+  });
+}
+
+/**
+ * @brief Método que evoluciona una regla y calcula sus estadísticas.
+ * El retículo se para en cuanto detecta un ciclo. Entonces la serie de densidad se completa repitiendo
+ * las generaciones del ciclo, que son las que habría dado la evolución completa, y el retículo salta a
+ * la última generación con FastForward para calcular la entropía de bloques.
+ * @param rule código de Wolfram de la regla
+ * @return RuleStats estadísticas de la regla
+ */
+RuleStats RuleSweep::Measure(const int& rule) const {
+  const auto start = std::chrono::steady_clock::now();
+  PackedLattice lattice(size_, borderType_, openState_, rule);
+  lattice.setSimdLevel(simd_level_);
+  lattice.LoadRow(row_.data(), 0);
+  lattice.setRecordDensity(true);
+  lattice.setCycleDetection(true);
+  lattice.Evolve(generations_);
+  std::vector<double> density = lattice.getDensity();
+  RuleStats stats;
+  stats.rule = rule;
+  stats.computed = lattice.getGeneration();
+  const CycleDetector& cycles = lattice.getCycles();
+  if (cycles.Found()) {
+    stats.transient = cycles.getTransient();
+    stats.period = cycles.getPeriod();
+    for (long generation = density.size(); generation <= generations_; ++generation) {
+      density.push_back(density[stats.transient + (generation - stats.transient) % stats.period]);
+    }
+    // FastForward aún calcula hasta un periodo
+    stats.computed += (generations_ - stats.computed) % stats.period;
+    lattice.FastForward(generations_);
+  }
+  double sum = 0, squares = 0;
+  stats.min_density = stats.max_density = density[0];
+  for (const double& value : density) {
+    sum += value;
+    squares += value * value;
+    stats.min_density = std::min(stats.min_density, value);
+    stats.max_density = std::max(stats.max_density, value);
+  }
+  stats.final_density = density.back();
+  stats.mean_density = sum / density.size();
+  stats.density_deviation = std::sqrt(std::max(squares / density.size() - stats.mean_density * stats.mean_density, 0.0));
+  std::vector<uint8_t> row(row_.size());
+  lattice.PackRow(row.data(), false);
+  stats.block_entropy = BlockEntropy(row);
+  stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return stats;
+}
+
+/**
+ * @brief Método que calcula la entropía de bloques de una generación.
+ * Cada byte de la fila es un bloque de 8 células consecutivas, así que basta un histograma de los 256
+ * valores posibles. La entropía de Shannon se divide entre 8 para que quede entre 0 (todos los bloques
+ * iguales) y 1 (todos los bloques igual de frecuentes). Se descarta el último byte si está incompleto.
+ * @param row generación con un bit por célula
+ * @return double entropía de bloques por célula
+ */
+double RuleSweep::BlockEntropy(const std::vector<uint8_t>& row) const {
+  const std::size_t blocks = size_ / 8;
+  if (blocks == 0) {
+    return 0;
+  }
+  std::vector<std::size_t> histogram(256, 0);
+  for (std::size_t k = 0; k < blocks; ++k) {
+    ++histogram[row[k]];
+  }
+  double entropy = 0;
+  for (const std::size_t& count : histogram) {
+    if (count > 0) {
+      const double probability = static_cast<double>(count) / blocks;
+      entropy -= probability * std::log2(probability);
+    }
+  }
+  return entropy / 8;
+}
+
+/**
+ * @brief Método que guarda las estadísticas en un archivo CSV.
+ * La primera línea es la cabecera con el nombre de cada columna. El transitorio y el periodo son -1 si
+ * no se ha detectado ningún ciclo en las generaciones evolucionadas.
+ * @param file_name nombre del archivo de salida
+ */
+void RuleSweep::Save(const std::string& file_name) const {
+  std::ofstream output_file{file_name};
+  if (!output_file.is_open()) {
+    std::cerr << "Unable to open file " << file_name << " for saving." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  output_file << "rule,final_density,mean_density,min_density,max_density,density_deviation,transient,period,"
+              << "block_entropy,seconds" << '\n';
+  for (const RuleStats& stats : stats_) {
+    output_file << stats.rule << ',' << stats.final_density << ',' << stats.mean_density << ','
+                << stats.min_density << ',' << stats.max_density << ',' << stats.density_deviation << ','
+                << stats.transient << ',' << stats.period << ',' << stats.block_entropy << ','
+                << stats.seconds << '\n';
+  }
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file RuleSweep.h
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Creación de la clase RuleSweep (barrido del espacio de reglas).
+ * Evoluciona la misma configuración inicial, con la misma frontera, con cada una de las reglas pedidas
+ * (por defecto las 256 reglas elementales) y guarda unas estadísticas de cada una en un CSV, para
+ * clasificar el comportamiento de las reglas sin lanzar el programa una vez por regla.
+ * Cada regla es una tarea de un conjunto de hilos con robo de tareas: las reglas que llegan pronto a
+ * un ciclo terminan enseguida y sus hilos ayudan con las caóticas, que evolucionan todas las generaciones.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef RULESWEEP_H
+#define RULESWEEP_H
+
+#include "PackedLattice.h"
+#include "RuleSimd.h"
+#include "ThreadPool.h"
+
+/**
+ * @brief Estadísticas de una regla
+ * La densidad se toma de la población que calcula el núcleo en cada generación y el ciclo del hash que
+ * se guarda al cerrarla. Si se detecta un ciclo, las generaciones que faltan repiten las del ciclo.
+ */
+struct RuleStats {
+  int rule = 0; // código de Wolfram de la regla
+  double final_density = 0; // densidad de la última generación
+  double mean_density = 0; // densidad media de todas las generaciones
+  double min_density = 0; // densidad mínima
+  double max_density = 0; // densidad máxima
+  double density_deviation = 0; // desviación típica de la densidad
+  long transient = -1; // longitud del transitorio, -1 si no se ha detectado ciclo
+  long period = -1; // periodo del ciclo (1 si es un punto fijo), -1 si no se ha detectado
+  long computed = 0; // generaciones calculadas, menos que las pedidas si se salta con el ciclo
+  double block_entropy = 0; // entropía de bloques de 8 células de la última generación, entre 0 y 1
+  double seconds = 0; // tiempo que ha costado la regla
+};
+
+/**
+ * @brief Clase Barrido de reglas
+ * Guarda la configuración inicial con un bit por célula (como PackRow) y, para cada regla, crea un
+ * retículo empaquetado de un solo hilo, la carga con LoadRow y lo evoluciona con la detección de
+ * ciclos y la serie de densidad activadas.
+ */
+class RuleSweep {
+ public:
+  // Constructor que toma la configuración inicial y la frontera de un retículo empaquetado
+  RuleSweep(const PackedLattice& lattice, const long& generations);
+  // Getter de las estadísticas, en el orden de las reglas
+  const std::vector<RuleStats>& getStats() const { return stats_; }
+  // setter del nivel SIMD con el que se evoluciona cada regla
+  void setSimdLevel(const SimdLevel& level) { simd_level_ = level; }
+  // método que evoluciona todas las reglas repartidas entre los hilos
+  void Run(const std::vector<int>& rules, const std::size_t& threads);
+  // método que guarda las estadísticas en un archivo CSV, una línea por regla
+  void Save(const std::string& file_name) const;
+
+ private:
+  // método que evoluciona una regla y calcula sus estadísticas
+  RuleStats Measure(const int& rule) const;
+  // método que calcula la entropía de los bloques de 8 células de una generación
+  double BlockEntropy(const std::vector<uint8_t>& row) const;
+  std::vector<uint8_t> row_; // configuración inicial, un bit por célula
+  int size_; // número de células
+  BorderType borderType_; // tipo de frontera
+  State openState_; // estado de las células frontera si es abierta
+  long generations_; // generaciones que se evoluciona cada regla
+  SimdLevel simd_level_ = AUTO; // nivel SIMD de los retículos
+  std::vector<RuleStats> stats_; // estadísticas de cada regla
+};
+
+#endif // RULESWEEP_H
\ No newline at end of file
@@ -0,0 +1,115 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file SpacetimeWriter.cc
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Implementación de los métodos de la clase SpacetimeWriter.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+#include "SpacetimeWriter.h"
+
+/**
+ * @brief Construct a new SpacetimeWriter:: SpacetimeWriter object
+ * Abre el archivo, escribe la cabecera PBM si hace falta y arranca el hilo escritor.
+ * Si no se puede abrir el archivo, se termina el programa.
+ * @param filename nombre del archivo de salida
+ * @param format formato de salida
+ * @param width número de células de cada fila
+ * @param height número de filas (generaciones), solo para la cabecera PBM
+ */
+SpacetimeWriter::SpacetimeWriter(const std::string& filename, const SpacetimeFormat& format,
+                                 const std::size_t& width, const std::size_t& height)
+    : output_file_(filename, std::ios::binary), format_(format), row_bytes_((width + 7) / 8) {
+  if (!output_file_.is_open()) {
+    std::cerr << "Unable to open file " << filename << " for saving." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if (format_ == PBM) {
+    output_file_ << "P4\n" << width << ' ' << height << '\n';
+  }
+  // Cada bloque tiene sitio al menos para una fila
+  block_.resize(std::max(kBlockBytes, row_bytes_));
+  writer_ = std::thread(&SpacetimeWriter::WriterLoop, this);
+}
+
+/**
+ * @brief Destroy the SpacetimeWriter:: SpacetimeWriter object
+ */
+SpacetimeWriter::~SpacetimeWriter() {
+  Close();
+}
+
+/**
+ * @brief Método que pasa el bloque actual al hilo escritor.
+ * Si la cola está llena, espera a que el escritor termine un bloque.
+ */
+void SpacetimeWriter::Submit() {
+  std::vector<uint8_t> block;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    space_.wait(lock, [this] { return queue_.size() < kMaxQueued; });
+    block_.resize(used_);
+    queue_.push_back(std::move(block_));
+    if (!free_.empty()) {
+      block = std::move(free_.back());
+      free_.pop_back();
+    }
+  }
+  ready_.notify_one();
+  block.resize(std::max(kBlockBytes, row_bytes_));
+  block_ = std::move(block);
+  used_ = 0;
+}
+
+/**
+ * @brief Bucle del hilo escritor.
+ * Escribe los bloques en orden y los devuelve a la lista de libres. Termina cuando se cierra y la
+ * cola está vacía.
+ */
+void SpacetimeWriter::WriterLoop() {
+  while (true) {
+    std::vector<uint8_t> block;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      ready_.wait(lock, [this] { return closing_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      block = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    space_.notify_one();
+    output_file_.write(reinterpret_cast<const char*>(block.data()), block.size());
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push_back(std::move(block));
+  }
+}
+
+/**
+ * @brief Método que escribe lo que quede y cierra el archivo.
+ * Se puede llamar más de una vez; a partir de la primera no hace nada.
+ */
+void SpacetimeWriter::Close() {
+  if (closed_) {
+    return;
+  }
+  if (used_ > 0) {
+    Submit();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closing_ = true;
+  }
+  ready_.notify_one();
+  writer_.join();
+  output_file_.close();
+  closed_ = true;
+  if (output_file_.fail()) {
+    std::cerr << "Error writing the spacetime diagram." << std::endl;
+  }
+}
\ No newline at end of file
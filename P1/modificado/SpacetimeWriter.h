@@ -0,0 +1,92 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file SpacetimeWriter.h
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Creación de la clase SpacetimeWriter.
+ * Guarda el diagrama espacio-tiempo del autómata (una fila por generación) en un archivo binario con
+ * una célula por bit, en vez de un carácter por célula como operator<<. Puede ser una imagen PBM (P4),
+ * que se abre con cualquier visor, o un archivo de bits sin cabecera.
+ * Las filas se copian en bloques grandes y un hilo de fondo los escribe en el archivo, así que la
+ * simulación no espera al disco.
+ */
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef SPACETIMEWRITER_H
+#define SPACETIMEWRITER_H
+
+/**
+ * @brief Enumerado con los formatos de salida
+ * PBM: imagen P4, cada fila empieza en un byte nuevo y la primera célula es el bit más significativo.
+ * RAWBITS: sin cabecera, cada fila empieza en un byte nuevo y la primera célula es el bit menos
+ * significativo (el mismo orden que las palabras de PackedLattice).
+ */
+enum SpacetimeFormat { PBM, RAWBITS };
+
+/**
+ * @brief Clase Escritor del diagrama espacio-tiempo
+ * Las filas se empaquetan directamente en el bloque actual. Cuando no cabe otra fila, el bloque se
+ * pasa a la cola del hilo escritor y se sigue con un bloque libre. La cola tiene un máximo de bloques
+ * para que la memoria no crezca si el disco es más lento que la simulación.
+ */
+class SpacetimeWriter {
+ public:
+  // Constructor que abre el archivo y escribe la cabecera. height solo se usa en el formato PBM
+  SpacetimeWriter(const std::string& filename, const SpacetimeFormat& format, const std::size_t& width,
+                  const std::size_t& height);
+  // Destructor que escribe lo que quede y espera al hilo escritor
+  ~SpacetimeWriter();
+  // método que añade la generación actual del retículo como una fila más
+  template <typename LatticeType>
+  void WriteRow(const LatticeType& lattice);
+  // método que escribe lo que quede y cierra el archivo
+  void Close();
+
+ private:
+  // Tamaño de cada bloque y número máximo de bloques en la cola
+  static constexpr std::size_t kBlockBytes = 4 << 20;
+  static constexpr std::size_t kMaxQueued = 4;
+  // método que pasa el bloque actual al hilo escritor y toma uno libre
+  void Submit();
+  // bucle del hilo escritor
+  void WriterLoop();
+  std::ofstream output_file_;
+  SpacetimeFormat format_; // formato de salida
+  std::size_t row_bytes_; // bytes de cada fila
+  std::vector<uint8_t> block_; // bloque que se está rellenando
+  std::size_t used_ = 0; // bytes usados del bloque actual
+  std::deque<std::vector<uint8_t>> queue_; // bloques pendientes de escribir
+  std::vector<std::vector<uint8_t>> free_; // bloques ya escritos que se pueden reutilizar
+  std::mutex mutex_;
+  std::condition_variable ready_; // avisa al escritor de que hay bloques o de que debe terminar
+  std::condition_variable space_; // avisa a la simulación de que hay sitio en la cola
+  bool closing_ = false; // si el escritor debe terminar cuando vacíe la cola
+  bool closed_ = false; // si ya se ha cerrado el archivo
+  std::thread writer_;
+};
+
+/**
+ * @brief Método que añade la generación actual del retículo como una fila más.
+ * El retículo escribe la fila directamente en el bloque con su método PackRow.
+ * @param lattice retículo (Lattice o PackedLattice)
+ */
+template <typename LatticeType>
+void SpacetimeWriter::WriteRow(const LatticeType& lattice) {
+  if (used_ + row_bytes_ > block_.size()) {
+    Submit();
+  }
+  lattice.PackRow(block_.data() + used_, format_ == PBM);
+  used_ += row_bytes_;
+}
+
+#endif // SPACETIMEWRITER_H
\ No newline at end of file
@@ -0,0 +1,99 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file ThreadPool.h
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Creación de las clases Barrier, ThreadPool y WorkQueues.
+ * ThreadPool mantiene un conjunto de hilos creados una sola vez (persistentes) que ejecutan la misma
+ * tarea, cada uno con su número de hilo. Barrier permite que esos hilos se esperen entre sí, por
+ * ejemplo al terminar cada generación, y que el último en llegar haga un trabajo en serie antes de
+ * dejar continuar a los demás. WorkQueues reparte tareas independientes de duración muy distinta entre
+ * esos hilos, dejando que los que acaban antes roben tareas a los demás.
+ */
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+/**
+ * @brief Clase Barrera
+ * Los hilos que llaman a ArriveAndWait se bloquean hasta que han llegado todos. El último en llegar
+ * ejecuta la función de finalización y después despierta al resto.
+ */
+class Barrier {
+ public:
+  // Constructor que recibe el número de hilos que se esperan
+  explicit Barrier(const std::size_t& count) : count_(count) {}
+  // método que espera a todos los hilos, ejecutando antes la función de finalización
+  void ArriveAndWait(const std::function<void()>& completion = nullptr);
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::size_t count_; // número de hilos
+  std::size_t arrived_ = 0; // hilos que han llegado en esta fase
+  std::size_t phase_ = 0; // número de fase, para distinguir esperas consecutivas
+};
+
+/**
+ * @brief Clase Conjunto de hilos
+ * Los hilos se crean en el constructor y se quedan esperando. Run ejecuta la tarea en todos ellos a la
+ * vez (el hilo que llama a Run hace de hilo 0) y vuelve cuando todos han terminado.
+ */
+class ThreadPool {
+ public:
+  // Constructor que recibe el número de hilos, contando el que llama a Run
+  explicit ThreadPool(const std::size_t& threads);
+  // Destructor que termina los hilos
+  ~ThreadPool();
+  // Getter del número de hilos
+  std::size_t getThreads() const { return workers_.size() + 1; }
+  // método que ejecuta task(hilo) en todos los hilos y espera a que terminen
+  void Run(const std::function<void(std::size_t)>& task);
+
+ private:
+  // bucle de cada hilo persistente
+  void WorkerLoop(const std::size_t& id);
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable start_; // avisa de que hay una tarea nueva
+  std::condition_variable done_; // avisa de que todos han terminado
+  const std::function<void(std::size_t)>* task_ = nullptr; // tarea actual
+  std::size_t round_ = 0; // número de tarea, para que cada hilo la ejecute una sola vez
+  std::size_t pending_ = 0; // hilos que aún no han terminado la tarea actual
+  bool stop_ = false; // si los hilos deben terminar
+};
+
+/**
+ * @brief Clase Colas de trabajo con robo de tareas
+ * Las tareas (números de 0 a tasks - 1) se reparten en bloques contiguos, una cola por hilo. Cada hilo
+ * saca las suyas por delante y, cuando se le acaban, roba por detrás de las colas de los demás, así
+ * que ningún hilo se queda parado mientras otro tiene tareas pendientes.
+ */
+class WorkQueues {
+ public:
+  // Constructor que recibe el número de colas (una por hilo) y el número de tareas
+  WorkQueues(const std::size_t& queues, const std::size_t& tasks);
+  // método que da al hilo id su siguiente tarea, propia o robada; false si no queda ninguna
+  bool Pop(const std::size_t& id, std::size_t& task);
+
+ private:
+  /**
+   * @brief Cola de un hilo
+   */
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::size_t> tasks; // tareas pendientes, por delante las del dueño
+  };
+  std::vector<Queue> queues_;
+};
+
+#endif // THREADPOOL_H
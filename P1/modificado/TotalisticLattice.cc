@@ -0,0 +1,379 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file TotalisticLattice.cc
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Implementación de los métodos de la clase TotalisticLattice.
+ * Encontramos los constructores, la tabla de la regla, el paso por trozos con la suma deslizante y
+ * los métodos comunes con los otros retículos (densidad, ciclos, filas de un bit e impresión).
+ */
+
+#include "TotalisticLattice.h"
+
+/**
+ * @brief Tabla que pasa un byte empaquetado a las células que contiene, un byte por célula.
+ * Con campos de 2 bits un byte tiene 4 células y con campos de 4 bits tiene 2, así que cada byte se
+ * desempaqueta con una sola lectura de la tabla y una escritura de 4 bytes (en little-endian).
+ */
+template <int Bits>
+struct UnpackTable {
+  uint32_t cells[256];
+  UnpackTable() {
+    for (uint32_t byte = 0; byte < 256; ++byte) {
+      cells[byte] = 0;
+      for (int field = 0; field < 8 / Bits; ++field) {
+        cells[byte] |= ((byte >> (field * Bits)) & ((1U << Bits) - 1)) << (8 * field);
+      }
+    }
+  }
+};
+
+/**
+ * @brief Desempaqueta los bytes de las palabras a un byte por célula.
+ * Si count no es múltiplo de las células por byte, se escriben también las células sobrantes del
+ * último byte (y hasta 3 bytes más con campos de 4 bits).
+ */
+template <int Bits>
+static void UnpackCells(const uint64_t* words, uint8_t* cells, const std::size_t& count) {
+  static const UnpackTable<Bits> table;
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(words);
+  for (std::size_t cell = 0, byte = 0; cell < count; cell += 8 / Bits, ++byte) {
+    std::memcpy(cells + cell, &table.cells[bytes[byte]], sizeof(uint32_t));
+  }
+}
+
+/**
+ * @brief Empaqueta un byte por célula en los bytes de las palabras (count múltiplo de las células por byte).
+ * Con campos de 2 bits se leen 4 células como un número de 32 bits y una multiplicación coloca la
+ * célula j en los bits 24 + 2j (los productos cruzados quedan por debajo sin llevar acarreo o por
+ * encima); con campos de 4 bits se juntan 2 células con un desplazamiento.
+ */
+template <int Bits>
+static void PackCells(const uint8_t* cells, uint64_t* words, const std::size_t& count) {
+  uint8_t* bytes = reinterpret_cast<uint8_t*>(words);
+  for (std::size_t cell = 0, byte = 0; cell < count; cell += 8 / Bits, ++byte) {
+    if (Bits == 2) {
+      uint32_t value;
+      std::memcpy(&value, cells + cell, sizeof(uint32_t));
+      bytes[byte] = (value * 0x01041040U) >> 24;
+    } else {
+      uint16_t value;
+      std::memcpy(&value, cells + cell, sizeof(uint16_t));
+      bytes[byte] = value | value >> 4;
+    }
+  }
+}
+
+/**
+ * @brief Construct a new TotalisticLattice:: TotalisticLattice object
+ * Todas las células empiezan en estado 0 salvo la central, que empieza en estado 1.
+ * @param size número de células
+ * @param borderType tipo de frontera
+ * @param openState estado de las células frontera si es abierta
+ * @param states número de estados, entre 2 y 16
+ * @param radius radio de la vecindad
+ * @param code código de la regla
+ */
+TotalisticLattice::TotalisticLattice(const int& size, const BorderType& borderType, const int& openState,
+                                     const int& states, const int& radius, const uint64_t& code)
+    : size_(size), states_(states), radius_(radius), code_(code), borderType_(borderType), openState_(openState) {
+  Allocate();
+  setState(size_ / 2, 1);
+}
+
+/**
+ * @brief Construct a new TotalisticLattice:: TotalisticLattice object
+ * Se lee el estado de cada célula desde un archivo, separados por espacios. Si el archivo no se puede
+ * abrir, no tiene size estados o alguno no está entre 0 y k - 1, se termina el programa.
+ * @param file_name nombre del archivo de configuración inicial
+ */
+TotalisticLattice::TotalisticLattice(const int& size, const BorderType& borderType, const int& openState,
+                                     const int& states, const int& radius, const uint64_t& code,
+                                     const std::string& file_name)
+    : size_(size), states_(states), radius_(radius), code_(code), borderType_(borderType), openState_(openState) {
+  std::ifstream input_file{file_name};
+  if (!input_file.is_open()) {
+    std::cerr << "File could not be opened." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  Allocate();
+  int state, read = 0;
+  while (input_file >> state) {
+    if (state < 0 || state >= states_) {
+      std::cerr << "The state " << state << " in the file " << file_name << " is not between 0 and "
+                << states_ - 1 << "." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (read < size_) {
+      setState(read, state);
+    }
+    ++read;
+  }
+  if (read != size_) {
+    std::cerr << "Size specified in option \"-size\" does not match with the number of states in the file " << file_name << "." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+/**
+ * @brief Método que reserva las palabras y construye la tabla de la regla.
+ * La cifra s del código en base k es el estado para la suma s. Las cifras que no caben en los 64 bits
+ * del código son 0. La tabla tiene al menos 32 entradas para que la versión SIMD pueda leerla entera.
+ * Si el retículo no tiene células, se termina el programa.
+ */
+void TotalisticLattice::Allocate() {
+  if (size_ <= 0) {
+    std::cerr << "The size of the lattice must be greater than 0." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  bits_ = states_ <= 4 ? 2 : 4;
+  fields_ = 64 / bits_;
+  current_.assign((static_cast<std::size_t>(size_) + fields_ - 1) / fields_, 0);
+  next_.assign(current_.size(), 0);
+  const int max_sum = (2 * radius_ + 1) * (states_ - 1);
+  table_.assign(std::max(max_sum + 1, 32), 0);
+  uint64_t code = code_;
+  for (int sum = 0; sum <= max_sum && code > 0; ++sum) {
+    table_[sum] = code % states_;
+    code /= states_;
+  }
+  // El desempaquetado puede escribir hasta 3 bytes más allá de la última célula
+  window_.assign(kChunkCells + 2 * radius_ + 4, 0);
+  sums_.assign(kChunkCells, 0);
+  result_.assign(kChunkCells, 0);
+}
+
+/**
+ * @brief Método que devuelve el estado de la célula en la posición dada
+ * @return int estado de la célula
+ */
+int TotalisticLattice::getState(const Position& position) const {
+  const int shift = (position % fields_) * bits_;
+  return (current_[position / fields_] >> shift) & ((1ULL << bits_) - 1);
+}
+
+/**
+ * @brief Método que modifica el estado de la célula en la posición dada
+ * @param position posición de la célula
+ * @param state nuevo estado, entre 0 y k - 1
+ */
+void TotalisticLattice::setState(const Position& position, const int& state) {
+  const int shift = (position % fields_) * bits_;
+  uint64_t& word = current_[position / fields_];
+  population_ -= ((word >> shift) & ((1ULL << bits_) - 1)) != 0;
+  word = (word & ~(((1ULL << bits_) - 1) << shift)) | (static_cast<uint64_t>(state) << shift);
+  population_ += state != 0;
+}
+
+/**
+ * @brief Método que devuelve el estado de cualquier célula.
+ * Fuera del retículo se sigue la frontera, igual que las células frontera de Lattice pero con r
+ * células por lado: con la periódica se da la vuelta, con la reflectora se refleja en el extremo
+ * (la célula -1 es la 0, la -2 es la 1...) y con la abierta todas tienen el estado de la frontera.
+ * @param cell célula, de -r a size + r - 1
+ * @return int estado de la célula
+ */
+int TotalisticLattice::Neighbor(const long& cell) const {
+  if (cell >= 0 && cell < size_) {
+    return getState(cell);
+  }
+  switch (borderType_) {
+    case PERIODIC:
+      return getState(((cell % size_) + size_) % size_);
+    case REFLECTIVE:
+      return getState(cell < 0 ? -cell - 1 : 2L * size_ - 1 - cell);
+    default:
+      return openState_;
+  }
+}
+
+/**
+ * @brief Método que calcula un trozo de la siguiente generación.
+ * 1. Se desempaqueta el trozo a un byte por célula, más las r células de cada lado.
+ * 2. Se calcula la suma de cada vecindad: la primera completa y las demás sumando la célula que entra
+ * por la derecha y restando la que sale por la izquierda.
+ * 3. Cada suma se traduce a su estado con la tabla, con la versión SIMD (búsqueda de bytes en un
+ * registro) si las sumas no pasan de 31, y el resto con la versión escalar.
+ * 4. Se empaquetan los estados en las palabras del trozo en la siguiente generación.
+ * @param begin primera célula del trozo, múltiplo de las células por palabra
+ * @param end célula siguiente a la última
+ * @return std::size_t número de células con estado distinto de 0 en el trozo
+ */
+std::size_t TotalisticLattice::StepChunk(const long& begin, const long& end) {
+  const std::size_t count = end - begin;
+  uint8_t* window = window_.data();
+  // Las células de fuera del trozo se escriben después, porque la última palabra puede pisarlas
+  if (bits_ == 2) {
+    UnpackCells<2>(current_.data() + begin / fields_, window + radius_, count);
+  } else {
+    UnpackCells<4>(current_.data() + begin / fields_, window + radius_, count);
+  }
+  for (long cell = begin - radius_; cell < begin; ++cell) {
+    window[cell - begin + radius_] = Neighbor(cell);
+  }
+  for (long cell = end; cell < end + radius_; ++cell) {
+    window[cell - begin + radius_] = Neighbor(cell);
+  }
+  const std::size_t width = 2 * radius_ + 1;
+  // Las sumas no pasan de 255, así que se pueden llevar en un byte aunque la resta dé la vuelta
+  uint8_t sum = 0;
+  for (std::size_t k = 0; k < width; ++k) {
+    sum += window[k];
+  }
+  uint8_t* sums = sums_.data();
+  sums[0] = sum;
+  for (std::size_t cell = 1; cell < count; ++cell) {
+    sum += window[cell + width - 1] - window[cell - 1];
+    sums[cell] = sum;
+  }
+  uint8_t* result = result_.data();
+  std::size_t cell = 0;
+  if (simd_lookup_ != nullptr && (2 * radius_ + 1) * (states_ - 1) < 32) {
+    cell = simd_lookup_(sums, result, count, table_.data());
+  }
+  for (; cell < count; ++cell) {
+    result[cell] = table_[sums[cell]];
+  }
+  // Los campos de la última palabra que quedan fuera del retículo son 0
+  const std::size_t whole = (count + fields_ - 1) / fields_ * fields_;
+  std::fill(result + count, result + whole, 0);
+  // Las células distintas de 0 se cuentan de 8 en 8: al sumar 0x7f a cada byte (todos valen menos de
+  // 16, así que no hay acarreo entre bytes), el bit alto queda a 1 solo en los que no eran 0
+  std::size_t population = 0;
+  for (std::size_t cell = 0; cell < whole; cell += 8) {
+    uint64_t value;
+    std::memcpy(&value, result + cell, sizeof(uint64_t));
+    population += __builtin_popcountll((value + 0x7f7f7f7f7f7f7f7fULL) & 0x8080808080808080ULL);
+  }
+  if (bits_ == 2) {
+    PackCells<2>(result, next_.data() + begin / fields_, whole);
+  } else {
+    PackCells<4>(result, next_.data() + begin / fields_, whole);
+  }
+  return population;
+}
+
+/**
+ * @brief Método que evoluciona el autómata celular una generación.
+ * Los trozos leen la generación actual y escriben en la siguiente, y al terminar se intercambian.
+ */
+void TotalisticLattice::NextGeneration() {
+  std::size_t population = 0;
+  for (long begin = 0; begin < size_; begin += kChunkCells) {
+    population += StepChunk(begin, std::min<long>(begin + kChunkCells, size_));
+  }
+  current_.swap(next_);
+  population_ = population;
+  if (record_density_) {
+    density_.push_back(static_cast<double>(population_) / size_);
+  }
+  ++generation_;
+  if (detect_cycles_) {
+    cycles_.Record(Hash(), generation_);
+  }
+}
+
+/**
+ * @brief Método que evoluciona el autómata celular varias generaciones.
+ * Si se buscan ciclos, se para en la generación en la que se detecta el ciclo.
+ * @param generations número de generaciones
+ */
+void TotalisticLattice::Evolve(const long& generations) {
+  const bool searching = detect_cycles_ && !cycles_.Found();
+  for (long generation = 0; generation < generations && !(searching && cycles_.Found()); ++generation) {
+    NextGeneration();
+  }
+}
+
+/**
+ * @brief Método que activa o desactiva la serie temporal de densidad.
+ * Al activarla se guarda la densidad de la generación actual como primer valor.
+ * @param record si se guarda la densidad de cada generación
+ */
+void TotalisticLattice::setRecordDensity(const bool& record) {
+  record_density_ = record;
+  density_.clear();
+  if (record_density_) {
+    density_.push_back(static_cast<double>(population_) / size_);
+  }
+}
+
+/**
+ * @brief Método que activa o desactiva la detección de ciclos.
+ * El historial empieza con la generación actual.
+ * @param detect si se guarda el hash de cada generación
+ */
+void TotalisticLattice::setCycleDetection(const bool& detect) {
+  detect_cycles_ = detect;
+  cycles_.Reset();
+  if (detect_cycles_) {
+    cycles_.Record(Hash(), generation_);
+  }
+}
+
+/**
+ * @brief Método que salta a cualquier generación a partir del inicio del ciclo.
+ * @param generation generación a la que se salta, mayor o igual que el transitorio
+ * @return true si se ha saltado, false si aún no se ha detectado el ciclo o la generación es anterior
+ */
+bool TotalisticLattice::FastForward(const long& generation) {
+  if (!cycles_.Found() || generation < cycles_.getTransient()) {
+    return false;
+  }
+  const long period = cycles_.getPeriod();
+  Evolve(((generation - generation_) % period + period) % period);
+  generation_ = generation;
+  return true;
+}
+
+/**
+ * @brief Método que escribe la generación actual con un bit por célula.
+ * El bit es 1 si el estado de la célula es distinto de 0, así que los diagramas espacio-tiempo
+ * muestran dónde hay actividad.
+ * @param row destino, con sitio para (size + 7) / 8 bytes
+ * @param msb_first si la primera célula de cada byte va en el bit más significativo
+ */
+void TotalisticLattice::PackRow(uint8_t* row, const bool& msb_first) const {
+  for (int i = 0; i < size_; i += 8) {
+    uint8_t byte = 0;
+    for (int bit = 0; bit < 8 && i + bit < size_; ++bit) {
+      if (getState(i + bit) != 0) {
+        byte |= msb_first ? 0x80 >> bit : 1 << bit;
+      }
+    }
+    row[i / 8] = byte;
+  }
+}
+
+/**
+ * @brief Método que carga una generación con un bit por célula, al revés que PackRow.
+ * Cada célula queda en estado 0 o 1.
+ * @param row origen, (size + 7) / 8 bytes con la primera célula de cada byte en el bit menos significativo
+ * @param generation generación que se carga
+ */
+void TotalisticLattice::LoadRow(const uint8_t* row, const long& generation) {
+  std::fill(current_.begin(), current_.end(), 0);
+  population_ = 0;
+  for (int i = 0; i < size_; ++i) {
+    setState(i, (row[i / 8] >> (i % 8)) & 1);
+  }
+  generation_ = generation;
+}
+
+/**
+ * @brief Sobrecarga del operador de salida
+ * Las células en estado 0 se imprimen como espacios y el resto con su estado en hexadecimal.
+ * @param os flujo de salida
+ * @param lattice retículo a imprimir
+ * @return std::ostream& flujo de salida
+ */
+std::ostream& operator<<(std::ostream& os, const TotalisticLattice& lattice) {
+  const char digits[] = " 123456789abcdef";
+  std::string line(lattice.getSize(), ' ');
+  for (int i = 0; i < lattice.getSize(); ++i) {
+    line[i] = digits[lattice.getState(i)];
+  }
+  os << line << '\n';
+  return os;
+}
\ No newline at end of file
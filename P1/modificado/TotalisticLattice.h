@@ -0,0 +1,122 @@
+/**
+ * ************ PRÁCTICA 1 *************
+ * @file TotalisticLattice.h
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-07
+ * @brief Creación de la clase TotalisticLattice (retículo de k estados con regla totalista de radio r).
+ * Cada célula toma un estado entre 0 y k - 1 y su siguiente estado depende solo de la suma de los
+ * estados de las 2r + 1 células de su vecindad (ella misma y r vecinas a cada lado). La regla se da
+ * con su código: la cifra s del código escrito en base k es el siguiente estado cuando la suma es s.
+ * Las células se guardan empaquetadas en campos de 2 bits (k <= 4) o de 4 bits (k <= 16).
+ * Admite los mismos tipos de frontera que Lattice y tiene la misma interfaz de evolución, así que se
+ * usa con los mismos modos de ejecución y salidas (las salidas de un bit por célula marcan las
+ * células con estado distinto de 0).
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef TOTALISTICLATTICE_H
+#define TOTALISTICLATTICE_H
+
+#include "CycleDetector.h"
+#include "Lattice.h"
+#include "RuleSimd.h"
+
+/**
+ * @brief Clase Retículo totalista
+ * La célula i está en el campo i % fields_ de la palabra i / fields_. Cada generación se calcula por
+ * trozos de kChunkCells células: se desempaquetan a bytes junto con las r células de cada lado
+ * (las de fuera del retículo según la frontera), se calculan las sumas con una suma deslizante (sumar
+ * la célula que entra y restar la que sale, O(1) por célula sea cual sea el radio), se traduce cada
+ * suma a su estado con la tabla de la regla y se vuelven a empaquetar.
+ */
+class TotalisticLattice {
+ public:
+  // Constructor para cuando no hay archivo de configuración inicial, solo la célula central en estado 1
+  TotalisticLattice(const int& size, const BorderType& borderType, const int& openState, const int& states,
+                    const int& radius, const uint64_t& code);
+  // Constructor que lee la configuración inicial (un estado entre 0 y k - 1 por célula) desde un archivo
+  TotalisticLattice(const int& size, const BorderType& borderType, const int& openState, const int& states,
+                    const int& radius, const uint64_t& code, const std::string& file_name);
+  // Getters de la clase
+  int getSize() const { return size_; }
+  int getStates() const { return states_; }
+  int getRadius() const { return radius_; }
+  uint64_t getCode() const { return code_; }
+  // setter del nivel SIMD con el que se traducen las sumas
+  void setSimdLevel(const SimdLevel& level) { simd_lookup_ = GetSimdLookup(level); }
+  // método que devuelve el estado de la célula en la posición dada
+  int getState(const Position&) const;
+  // método modificador para poder establecer la configuración inicial
+  void setState(const Position&, const int&);
+  // método que evoluciona el autómata celular
+  void NextGeneration();
+  // método que evoluciona el autómata celular varias generaciones seguidas
+  void Evolve(const long&);
+  // Metodo que devuelve el numero de celulas con estado distinto de 0, sin recorrer el retículo
+  std::size_t CountAliveCells() const { return population_; }
+  // método que activa o desactiva la serie temporal de densidad (células distintas de 0 / tamaño)
+  void setRecordDensity(const bool&);
+  // Getter de la serie temporal de densidad, un valor por generación
+  const std::vector<double>& getDensity() const { return density_; }
+  // Getter de la generación actual (0 es la configuración inicial)
+  long getGeneration() const { return generation_; }
+  // método que activa o desactiva la detección de ciclos, empezando por la generación actual
+  void setCycleDetection(const bool&);
+  // Getter del detector de ciclos, con el transitorio y el periodo si ya se han detectado
+  const CycleDetector& getCycles() const { return cycles_; }
+  // método que salta a cualquier generación del ciclo ya detectado; false si no se puede
+  bool FastForward(const long& generation);
+  // método que devuelve el hash de 128 bits del estado actual, con todos los bits de cada célula
+  StateHash Hash() const { return HashWords(current_.data(), current_.size()); }
+  // método que escribe la generación actual con un bit por célula (1 si es distinta de 0)
+  void PackRow(uint8_t* row, const bool& msb_first) const;
+  // método que carga una generación con un bit por célula (estados 0 y 1)
+  void LoadRow(const uint8_t* row, const long& generation);
+  // método que imprime el estado del retículo
+  friend std::ostream& operator<<(std::ostream&, const TotalisticLattice&);
+
+ private:
+  // Células de cada trozo (múltiplo de las células por palabra con campos de 2 y de 4 bits)
+  static constexpr long kChunkCells = 4096;
+  // método que reserva las palabras y construye la tabla de la regla
+  void Allocate();
+  // método que devuelve el estado de cualquier célula, fuera del retículo según la frontera
+  int Neighbor(const long& cell) const;
+  // método que calcula las células [begin, end) de la siguiente generación
+  std::size_t StepChunk(const long& begin, const long& end);
+  std::vector<uint64_t> current_; // generación actual
+  std::vector<uint64_t> next_; // siguiente generación
+  int size_; // número de células (sin contar la frontera)
+  int states_; // número de estados (k)
+  int radius_; // radio de la vecindad (r)
+  uint64_t code_; // código de la regla
+  int bits_; // bits de cada campo, 2 o 4
+  int fields_; // células por palabra
+  BorderType borderType_; // tipo de frontera
+  int openState_; // estado de las células frontera si es abierta
+  std::vector<uint8_t> table_; // siguiente estado para cada suma, con al menos 32 entradas
+  std::vector<uint8_t> window_; // estados del trozo con r células a cada lado
+  std::vector<uint8_t> sums_; // suma de la vecindad de cada célula del trozo
+  std::vector<uint8_t> result_; // siguiente estado de cada célula del trozo
+  SimdLookupFunction simd_lookup_ = GetSimdLookup(AUTO); // traducción vectorial, nullptr si es escalar
+  std::size_t population_ = 0; // número de células con estado distinto de 0
+  bool record_density_ = false; // si se guarda la serie temporal de densidad
+  std::vector<double> density_; // densidad de cada generación
+  long generation_ = 0; // generación actual
+  bool detect_cycles_ = false; // si se guarda el hash de cada generación
+  CycleDetector cycles_; // historial de hashes y ciclo detectado
+};
+
+// Sobrecarga del operador de salida
+std::ostream& operator<<(std::ostream&, const TotalisticLattice&);
+
+#endif // TOTALISTICLATTICE_H
\ No newline at end of file
@@ -12,9 +12,70 @@
 #include <iostream>
 #include <fstream>
 #include <cstring>
+#include <chrono>
+#include <sstream>
+#include <algorithm>
+#include <memory>
+#include <utility>
 
 #include "Cell.h"
+#include "ColumnStream.h"
 #include "Lattice.h"
+#include "BinaryConfig.h"
+#include "EnsembleLattice.h"
+#include "History.h"
+#include "PackedLattice.h"
+#include "RuleSweep.h"
+#include "SpacetimeWriter.h"
+#include "TotalisticLattice.h"
+
+/**
+ * @brief Estructura con los argumentos de la línea de comandos
+ * Se rellena en checkArgs y se usa en main para crear y evolucionar el retículo.
+ */
+struct Arguments {
+  int size = 0; // tamaño del retículo
+  BorderType borderType = PERIODIC; // tipo de frontera
+  State openState = DEAD; // estado de la frontera abierta
+  bool borderGiven = false; // si la frontera se ha indicado con '-border'
+  std::string filename; // archivo de configuración inicial
+  bool binaryInit = false; // si el archivo de configuración inicial está en formato binario
+  double density = -1; // densidad de la configuración inicial aleatoria, -1 si no es aleatoria
+  std::string convertFile; // archivo binario al que se convierte la configuración inicial
+  int rule = 30; // código de Wolfram de la regla
+  bool ruleGiven = false; // si la regla se ha indicado con '-rule'
+  int states = 0; // número de estados de la regla totalista, 0 si se usa una regla elemental
+  int radius = 1; // radio de la vecindad de la regla totalista
+  uint64_t totalisticCode = 0; // código de la regla totalista
+  bool packed = false; // si se usa el retículo empaquetado
+  SimdLevel simdLevel = AUTO; // nivel SIMD del retículo empaquetado
+  std::size_t threads = 1; // hilos con los que se evoluciona el retículo empaquetado
+  int jump = -1; // logaritmo en base 2 del salto del motor de macro-células, -1 si no se usa
+  int block = 0; // generaciones por tesela del bloqueo temporal, 0 si no se usa
+  std::vector<std::pair<Position, long>> stateAt; // células (posición, generación) que se consultan
+  Position damage = -1; // célula que se cambia en el gemelo de la propagación del daño, -1 si no se analiza
+  std::string damageFile; // archivo donde se guarda la diferencia de cada generación con el gemelo
+  std::string streamFile; // archivo del flujo de bits de las columnas, '-' para la salida estándar
+  std::vector<long> columns; // columnas del flujo, vacío para usar la central
+  std::string saveWindow; // archivo donde se guarda la ventana del flujo al terminar
+  std::string resumeWindow; // archivo de la ventana desde la que continúa el flujo
+  std::size_t history = 0; // presupuesto del historial de fotogramas clave en MiB, 0 si no se guarda
+  long keyframe = 64; // generaciones entre fotogramas clave al empezar
+  bool rawKeyframes = false; // si los fotogramas se guardan completos, sin diferencias comprimidas
+  std::vector<long> rowAt; // generaciones que se reconstruyen con el historial al terminar
+  bool cycle = false; // si se detectan ciclos para terminar antes
+  std::string sweepFile; // archivo CSV del barrido de reglas
+  std::vector<int> rules; // reglas del barrido, vacío para las 256
+  std::string ensembleFile; // archivo con una configuración inicial por simulación del conjunto
+  std::size_t ensembleRandom = 0; // número de simulaciones aleatorias del conjunto
+  uint64_t seed = 1; // semilla de las configuraciones aleatorias
+  long generations = -1; // generaciones del modo por lotes, -1 si es interactivo
+  long printEvery = 1; // cada cuántas generaciones se imprime el retículo en el modo por lotes
+  bool quiet = false; // si no se imprime el retículo en el modo por lotes
+  std::string densityFile; // archivo donde se guarda la serie temporal de densidad
+  std::string spacetimeFile; // archivo donde se guarda el diagrama espacio-tiempo
+  SpacetimeFormat spacetimeFormat = PBM; // formato del diagrama espacio-tiempo
+};
 
 /**
  * @brief Función que imprime el modo de empleo del programa
@@ -28,11 +89,42 @@ void Usage(int argc, char* argv[]) {
     exit(EXIT_FAILURE);
   }
   if ((argc == 2 && std::string(argv[1]) == "--help") || std::string(argv[1]) == "-h") {
-    std::cout << "Modo de empleo: " << argv[0] << " -size <n> -border <type> [0|1] [-init <file>]" << std::endl;
+    std::cout << "Modo de empleo: " << argv[0] << " -size <n> -border <type> [0|1] [-init <file> | -random <density> [-seed <n>]] [-convert <file>] [-rule <0..255> | -totalistic <k> <r> <code>] [-packed] [-simd <level>] [-threads <n>] [-jump <2^k>] [-block <k>] [-state-at <position> <generation>] [-damage <position> <file>] [-stream <file|-> [-columns <c1,c2,...>] [-save-window <file>] [-resume <file>]] [-history <MiB> [-keyframe <K>] [-raw-keyframes] [-row-at <generation>]] [-gens <n> [-print-every <k>] [-quiet]] [-density <file>] [-cycle] [-pbm <file> | -rawbits <file>] [-sweep <file.csv> [-rules <all|r1,r2,...>]] [-ensemble <file> | -ensemble random <count> [-seed <n>]]" << std::endl;
     std::cout << "Donde: " << std::endl;
-    std::cout << "  -size <n> : Tamaño del retículo obligatorio" << std::endl;
+    std::cout << "  -size <n> : Tamaño del retículo obligatorio, salvo con un -init binario o con -resume" << std::endl;
     std::cout << "  -border <type> [0|1]: Tipo de frontera. Puede ser 'open', 'periodic' o 'reflective. Obligatotio.'" << std::endl;
-    std::cout << "  -init <file> : Archivo de configuración inicial (opcional)" << std::endl;
+    std::cout << "  -init <file> : Archivo de configuración inicial, de texto o binario. Si es binario, el tamaño, la frontera y la regla se toman de su cabecera y, si se indican con -size, -border o -rule, tienen que coincidir (opcional)" << std::endl;
+    std::cout << "  -random <density> : Configuración inicial aleatoria, cada célula viva con esa probabilidad (entre 0 y 1). Con -threads se genera en paralelo y sale la misma con cualquier número de hilos (opcional)" << std::endl;
+    std::cout << "  -convert <file> : Guarda la configuración de '-init' en formato binario empaquetado y termina (opcional)" << std::endl;
+    std::cout << "  -rule <0..255> : Código de Wolfram de la regla que se aplica. Por defecto la 30 (opcional)" << std::endl;
+    std::cout << "  -totalistic <k> <r> <code> : Regla totalista de k estados (2..16) y radio r: la cifra s del código en base k es el siguiente estado si la vecindad de 2r + 1 células suma s. La configuración inicial tiene un estado por célula (opcional)" << std::endl;
+    std::cout << "  -packed : Usa el retículo empaquetado, 64 células por palabra y 1 bit por célula (opcional)" << std::endl;
+    std::cout << "  -simd <level> : Con -packed o -totalistic, fuerza 'scalar', 'sse2', 'avx2' o 'avx512'. Por defecto el mejor del procesador (opcional)" << std::endl;
+    std::cout << "  -threads <n> : Con -packed, evoluciona el retículo con n hilos. Por defecto 1 (opcional)" << std::endl;
+    std::cout << "  -jump <2^k> : Con -packed y frontera periódica, avanza a saltos de 2^k generaciones con el motor de macro-células memorizado (opcional)" << std::endl;
+    std::cout << "  -block <k> : Con -packed, bloqueo temporal: recorre el retículo por teselas que caben en la caché y avanza cada una k generaciones (opcional)" << std::endl;
+    std::cout << "  -state-at <position> <generation> : Con -packed, imprime el estado de la célula en esa generación evolucionando solo su cono de luz. Se puede repetir (opcional)" << std::endl;
+    std::cout << "  -damage <position> <file> : Con -packed y -gens, evoluciona un gemelo con esa célula cambiada y guarda en el archivo, por generación, las células distintas y la primera y la última de ellas, contadas desde la célula cambiada (opcional)" << std::endl;
+    std::cout << "  -stream <file|-> : Con -gens, escribe los bits de las columnas de n generaciones empaquetados en bytes (el primero en el bit más significativo) sobre una línea infinita con fondo muerto. '-' es la salida estándar (opcional)" << std::endl;
+    std::cout << "  -columns <c1,c2,...> : Columnas del flujo, relativas a la primera célula de la configuración inicial. Por defecto la central (opcional)" << std::endl;
+    std::cout << "  -save-window <file> : Al terminar el flujo, guarda la ventana para continuarlo después (opcional)" << std::endl;
+    std::cout << "  -resume <file> : Continúa el flujo desde una ventana guardada, con su regla y sus columnas (opcional)" << std::endl;
+    std::cout << "  -history <MiB> : Guarda un fotograma clave cada K generaciones sin pasar de ese presupuesto (duplicando K si hace falta). En el modo interactivo, 'b' vuelve atrás y 'g <n>' va a la generación n (opcional)" << std::endl;
+    std::cout << "  -keyframe <K> : Con -history, generaciones entre fotogramas clave al empezar. Por defecto 64 (opcional)" << std::endl;
+    std::cout << "  -raw-keyframes : Con -history, guarda los fotogramas completos en vez de como diferencia comprimida con el anterior (opcional)" << std::endl;
+    std::cout << "  -row-at <generation> : Con -history y -gens, al terminar imprime el retículo en esa generación reconstruido desde el historial. Se puede repetir (opcional)" << std::endl;
+    std::cout << "  -gens <n> : Modo por lotes, evoluciona n generaciones sin esperar al usuario (opcional)" << std::endl;
+    std::cout << "  -print-every <k> : En el modo por lotes, imprime el retículo cada k generaciones. Por defecto 1 (opcional)" << std::endl;
+    std::cout << "  -quiet : En el modo por lotes, no imprime el retículo, solo el resumen final (opcional)" << std::endl;
+    std::cout << "  -density <file> : Guarda en el archivo la densidad de cada generación (opcional)" << std::endl;
+    std::cout << "  -cycle : Detecta el transitorio y el periodo del ciclo. En el modo por lotes, al detectarlo salta directamente a la última generación (opcional)" << std::endl;
+    std::cout << "  -pbm <file> : Con -gens, guarda el diagrama espacio-tiempo como imagen PBM, un bit por célula (opcional)" << std::endl;
+    std::cout << "  -rawbits <file> : Guarda el diagrama espacio-tiempo como bits sin cabecera, (size + 7) / 8 bytes por generación (opcional)" << std::endl;
+    std::cout << "  -sweep <file.csv> : Con -gens, evoluciona la misma configuración inicial con cada regla y guarda en el CSV su densidad, su ciclo y su entropía de bloques. Las reglas se reparten entre los hilos de '-threads' (opcional)" << std::endl;
+    std::cout << "  -rules <all|r1,r2,...> : Reglas del barrido, separadas por comas. Por defecto todas (opcional)" << std::endl;
+    std::cout << "  -ensemble <file> : Con -gens, evoluciona a la vez una simulación por cada línea del archivo, 64 por palabra (opcional)" << std::endl;
+    std::cout << "  -ensemble random <count> : Con -gens, evoluciona a la vez count simulaciones con configuraciones aleatorias (opcional)" << std::endl;
+    std::cout << "  -seed <n> : Semilla de las configuraciones aleatorias de '-random' y '-ensemble random'. Por defecto 1 (opcional)" << std::endl;
     std::cout << std::endl;
     std::cout << "Funcionalidades del programa:" << std::endl;
     std::cout << "  Este programa se encarga de hacer un autómata celular. Este es un modelo matemático y computacional para un sistema dinámico ";
@@ -49,17 +141,16 @@ void Usage(int argc, char* argv[]) {
  * Hace todo el control de versiones de los argumentos.
  * @param argc es el número de argumentos
  * @param argv es el nombre de los argumentos
- * @param size tamaño del reticulo
- * @param borderType tipo de frontera que se le asigna al retículo por linea de comandos
+ * @param args argumentos comprobados
  */
-void checkArgs(int argc, char* argv[], int& size, BorderType& borderType, std::string& filename) {
+void checkArgs(int argc, char* argv[], Arguments& args) {
   for (int i = 1; i < argc; i++) {
     std::string arg = argv[i];
     // Comprobación del size
     if (arg == "-size") {
       if (i + 1 < argc) {
-        size = std::stoi(argv[++i]);
-        if (size <= 0) {
+        args.size = std::stoi(argv[++i]);
+        if (args.size <= 0) {
           std::cerr << "El tamaño del retículo debe ser un número entero positivo" << std::endl;
           exit(EXIT_FAILURE);
         }
@@ -71,23 +162,25 @@ void checkArgs(int argc, char* argv[], int& size, BorderType& borderType, std::s
     } else if (arg == "-border") {
        if (i + 1 < argc) {
         std::string borderArg = argv[++i];
+        args.borderGiven = true;
         // Comprobación directa de las opciones válidas
         if (borderArg == "open") {
-          borderType = OPEN;
+          args.borderType = OPEN;
           if (i + 1 < argc) {
             int option = std::stoi(argv[++i]);
             if (option != 0 && option != 1) {
               std::cerr << "La opción de frontera abierta debe ser 0 o 1" << std::endl;
               exit(EXIT_FAILURE);
             }
+            args.openState = static_cast<State>(option);
           } else {
             std::cerr << "Opción de frontera abierta no encontrada. Use '-border open <option>'" << std::endl;
             exit(EXIT_FAILURE);
           }
         } else if (borderArg == "periodic") {
-          borderType = PERIODIC;
+          args.borderType = PERIODIC;
         } else if (borderArg == "reflective") {
-          borderType = REFLECTIVE;
+          args.borderType = REFLECTIVE;
         } else {
           std::cerr << "Tipo de frontera no reconocido. Use '-border <type>'" << std::endl;
           exit(EXIT_FAILURE);
@@ -99,16 +192,485 @@ void checkArgs(int argc, char* argv[], int& size, BorderType& borderType, std::s
     // Comprobación del archivo de configuración inicial -- > si existe
     } else if (arg == "-init") {
       if (i + 1 < argc) {
-        filename = argv[++i];
+        args.filename = argv[++i];
       } else {
         std::cerr << "Archivo de configuración inicial no encontrado. Use '-init <filename>'" << std::endl;
         exit(EXIT_FAILURE);
       }
+    // Configuración inicial aleatoria
+    } else if (arg == "-random") {
+      if (i + 1 < argc) {
+        args.density = std::stod(argv[++i]);
+        if (args.density < 0 || args.density > 1) {
+          std::cerr << "La densidad debe ser un número entre 0 y 1" << std::endl;
+          exit(EXIT_FAILURE);
+        }
+      } else {
+        std::cerr << "Densidad no encontrada. Use '-random <density>'" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    // Conversión al formato binario
+    } else if (arg == "-convert") {
+      if (i + 1 < argc) {
+        args.convertFile = argv[++i];
+      } else {
+        std::cerr << "Archivo binario de salida no encontrado. Use '-convert <file>'" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    // Comprobación de la regla
+    } else if (arg == "-rule") {
+      if (i + 1 < argc) {
+        args.rule = std::stoi(argv[++i]);
+        args.ruleGiven = true;
+        if (args.rule < 0 || args.rule > 255) {
+          std::cerr << "La regla debe ser un número entre 0 y 255" << std::endl;
+          exit(EXIT_FAILURE);
+        }
+      } else {
+        std::cerr << "Regla no encontrada. Use '-rule <0..255>'" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    // Regla totalista de k estados y radio r
+    } else if (arg == "-totalistic") {
+      if (i + 3 < argc) {
+        args.states = std::stoi(argv[++i]);
+        args.radius = std::stoi(argv[++i]);
+        args.totalisticCode = std::stoull(argv[++i]);
+        if (args.states < 2 || args.states > 16 || args.radius < 1 || (2 * args.radius + 1) * (args.states - 1) > 255) {
+          std::cerr << "La regla totalista necesita entre 2 y 16 estados y un radio de al menos 1 con el que "
+                    << "la suma de la vecindad no pase de 255" << std::endl;
+          exit(EXIT_FAILURE);
+        }
+      } else {
+        std::cerr << "Regla totalista no encontrada. Use '-totalistic <k> <r> <code>'" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    // Retículo empaquetado
+    } else if (arg == "-packed") {
+      args.packed = true;
+    // Nivel SIMD del retículo empaquetado
+    } else if (arg == "-simd") {
+      if (i + 1 < argc) {
+        std::string levelArg = argv[++i];
+        if (levelArg == "scalar") {
+          args.simdLevel = SCALAR;
+        } else if (levelArg == "sse2") {
+          args.simdLevel = SSE2;
+        } else if (levelArg == "avx2") {
+          args.simdLevel = AVX2;
+        } else if (levelArg == "avx512") {
+          args.simdLevel = AVX512;
+        } else {
+          std::cerr << "Nivel SIMD no reconocido. Use '-simd <scalar|sse2|avx2|avx512>'" << std::endl;
+          exit(EXIT_FAILURE);
+        }
+        // No se puede forzar un nivel que el procesador no admite
+        if (args.simdLevel > DetectSimdLevel()) {
+          std::cerr << "El procesador no admite el nivel SIMD " << levelArg << std::endl;
+          exit(EXIT_FAILURE);
+        }
+      } else {
+        std::cerr << "Nivel SIMD no encontrado. Use '-simd <scalar|sse2|avx2|avx512>'" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    // Número de hilos del retículo empaquetado
+    } else if (arg == "-threads") {
+      if (i + 1 < argc) {
+        const int threads = std::stoi(argv[++i]);
+        if (threads <= 0) {
+          std::cerr << "El número de hilos debe ser un número entero positivo" << std::endl;
+          exit(EXIT_FAILURE);
+        }
+        args.threads = threads;
+      } else {
+        std::cerr << "Número de hilos no encontrado. Use '-threads <n>'" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    // Salto del motor de macro-células, solo en la forma 2^k (k entre 0 y 40)
+    } else if (arg == "-jump") {
+      if (i + 1 < argc) {
+        const std::string jumpArg = argv[++i];
+        // Solo se acepta la forma 2^k, para que '-jump 8' no se confunda con un salto de 8 generaciones
+        if (jumpArg.compare(0, 2, "2^") != 0 || jumpArg.size() == 2 || !isdigit(jumpArg[2])) {
+          std::cerr << "El salto debe escribirse como 2^k. Use '-jump <2^k>'" << std::endl;
+          exit(EXIT_FAILURE);
+        }
+        args.jump = std::stoi(jumpArg.substr(2));
+        if (args.jump < 0 || args.jump > 40) {
+          std::cerr << "El salto debe ser 2^k con k entre 0 y 40" << std::endl;
+          exit(EXIT_FAILURE);
+        }
+      } else {
+        std::cerr << "Salto no encontrado. Use '-jump <2^k>'" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    // Generaciones por tesela del bloqueo temporal
+    } else if (arg == "-block") {
+      if (i + 1 < argc) {
+        args.block = std::stoi(argv[++i]);
+        if (args.block < 1 || args.block > 1024) {
+          std::cerr << "Las generaciones por tesela deben estar entre 1 y 1024" << std::endl;
+          exit(EXIT_FAILURE);
+        }
+      } else {
+        std::cerr << "Generaciones por tesela no encontradas. Use '-block <k>'" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    // Flujo de bits de las columnas
+    } else if (arg == "-stream" || arg == "-save-window" || arg == "-resume") {
+      if (i + 1 < argc) {
+        std::string& file = arg == "-stream" ? args.streamFile : arg == "-save-window" ? args.saveWindow : args.resumeWindow;
+        file = argv[++i];
+      } else {
+        std::cerr << "Archivo no encontrado. Use '" << arg << " <file>'" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    // Historial de fotogramas clave
+    } else if (arg == "-history" || arg == "-keyframe" || arg == "-row-at") {
+      if (i + 1 < argc) {
+        const long value = std::stol(argv[++i]);
+        if (value < (arg == "-row-at" ? 0 : 1)) {
+          std::cerr << "El valor de '" << arg << "' no es válido" << std::endl;
+          exit(EXIT_FAILURE);
+        }
+        if (arg == "-history") {
+          args.history = value;
+        } else if (arg == "-keyframe") {
+          args.keyframe = value;
+        } else {
+          args.rowAt.push_back(value);
+        }
+      } else {
+        std::cerr << "Valor no encontrado. Use '" << arg << " <n>'" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    } else if (arg == "-raw-keyframes") {
+      args.rawKeyframes = true;
+    // Columnas del flujo, separadas por comas
+    } else if (arg == "-columns") {
+      if (i + 1 < argc) {
+        std::istringstream columns{argv[++i]};
+        std::string column;
+        while (std::getline(columns, column, ',')) {
+          args.columns.push_back(std::stol(column));
+        }
+      } else {
+        std::cerr << "Columnas no encontradas. Use '-columns <c1,c2,...>'" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    // Consulta de una célula en una generación, se puede repetir
+    } else if (arg == "-state-at") {
+      if (i + 2 < argc) {
+        const Position position = std::stoi(argv[++i]);
+        const long generation = std::stol(argv[++i]);
+        if (position < 0 || generation < 0) {
+          std::cerr << "La posición y la generación deben ser números enteros no negativos" << std::endl;
+          exit(EXIT_FAILURE);
+        }
+        args.stateAt.emplace_back(position, generation);
+      } else {
+        std::cerr << "Célula no encontrada. Use '-state-at <position> <generation>'" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    // Propagación del daño
+    } else if (arg == "-damage") {
+      if (i + 2 < argc) {
+        args.damage = std::stoi(argv[++i]);
+        args.damageFile = argv[++i];
+        if (args.damage < 0) {
+          std::cerr << "La posición debe ser un número entero no negativo" << std::endl;
+          exit(EXIT_FAILURE);
+        }
+      } else {
+        std::cerr << "Célula o archivo no encontrados. Use '-damage <position> <file>'" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    // Modo por lotes
+    } else if (arg == "-gens") {
+      if (i + 1 < argc) {
+        args.generations = std::stol(argv[++i]);
+        if (args.generations < 0) {
+          std::cerr << "El número de generaciones debe ser un número entero no negativo" << std::endl;
+          exit(EXIT_FAILURE);
+        }
+      } else {
+        std::cerr << "Número de generaciones no encontrado. Use '-gens <n>'" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    } else if (arg == "-print-every") {
+      if (i + 1 < argc) {
+        args.printEvery = std::stol(argv[++i]);
+        if (args.printEvery <= 0) {
+          std::cerr << "El intervalo de impresión debe ser un número entero positivo" << std::endl;
+          exit(EXIT_FAILURE);
+        }
+      } else {
+        std::cerr << "Intervalo de impresión no encontrado. Use '-print-every <k>'" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    } else if (arg == "-quiet") {
+      args.quiet = true;
+    // Serie temporal de densidad
+    } else if (arg == "-density") {
+      if (i + 1 < argc) {
+        args.densityFile = argv[++i];
+      } else {
+        std::cerr << "Archivo de densidad no encontrado. Use '-density <file>'" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    // Conjunto de simulaciones, desde archivo o aleatorias
+    } else if (arg == "-ensemble") {
+      if (i + 1 < argc && std::string(argv[i + 1]) == "random") {
+        ++i;
+        if (i + 1 < argc) {
+          const long count = std::stol(argv[++i]);
+          if (count <= 0) {
+            std::cerr << "El número de simulaciones debe ser un número entero positivo" << std::endl;
+            exit(EXIT_FAILURE);
+          }
+          args.ensembleRandom = count;
+        } else {
+          std::cerr << "Número de simulaciones no encontrado. Use '-ensemble random <count>'" << std::endl;
+          exit(EXIT_FAILURE);
+        }
+      } else if (i + 1 < argc) {
+        args.ensembleFile = argv[++i];
+      } else {
+        std::cerr << "Archivo de configuraciones no encontrado. Use '-ensemble <file>'" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    } else if (arg == "-seed") {
+      if (i + 1 < argc) {
+        args.seed = std::stoull(argv[++i]);
+      } else {
+        std::cerr << "Semilla no encontrada. Use '-seed <n>'" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    // Barrido de reglas
+    } else if (arg == "-sweep") {
+      if (i + 1 < argc) {
+        args.sweepFile = argv[++i];
+      } else {
+        std::cerr << "Archivo del barrido no encontrado. Use '-sweep <file.csv>'" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    // Reglas del barrido, separadas por comas
+    } else if (arg == "-rules") {
+      if (i + 1 < argc) {
+        const std::string rulesArg = argv[++i];
+        std::istringstream rules{rulesArg == "all" ? "" : rulesArg};
+        std::string rule;
+        while (std::getline(rules, rule, ',')) {
+          args.rules.push_back(std::stoi(rule));
+          if (args.rules.back() < 0 || args.rules.back() > 255) {
+            std::cerr << "La regla debe ser un número entre 0 y 255" << std::endl;
+            exit(EXIT_FAILURE);
+          }
+        }
+        if (rulesArg == "all") {
+          args.rules.clear();
+        }
+      } else {
+        std::cerr << "Reglas no encontradas. Use '-rules <all|r1,r2,...>'" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    // Detección de ciclos
+    } else if (arg == "-cycle") {
+      args.cycle = true;
+    // Diagrama espacio-tiempo
+    } else if (arg == "-pbm" || arg == "-rawbits") {
+      if (i + 1 < argc) {
+        args.spacetimeFile = argv[++i];
+        args.spacetimeFormat = arg == "-pbm" ? PBM : RAWBITS;
+      } else {
+        std::cerr << "Archivo del diagrama espacio-tiempo no encontrado. Use '" << arg << " <file>'" << std::endl;
+        exit(EXIT_FAILURE);
+      }
     } else {
       std::cerr << "Argumento no reconocido: " << arg << std::endl;
       exit(EXIT_FAILURE);
     }
   }
+  // Si la configuración inicial es binaria, su cabecera manda sobre el tamaño, la frontera y la regla.
+  // Si también se indican en la línea de comandos, tienen que coincidir con la cabecera
+  if (!args.filename.empty() && BinaryConfig::IsBinary(args.filename)) {
+    const BinaryConfig config(args.filename);
+    if (args.size != 0 && args.size != config.getSize()) {
+      std::cerr << "Size specified in option \"-size\" does not match with the size in the file " << args.filename << "." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (args.borderGiven && (args.borderType != config.getBorderType() ||
+                             (args.borderType == OPEN && args.openState != config.getOpenState()))) {
+      std::cerr << "Border specified in option \"-border\" does not match with the border in the file " << args.filename << "." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (args.ruleGiven && args.rule != config.getRule()) {
+      std::cerr << "Rule specified in option \"-rule\" does not match with the rule in the file " << args.filename << "." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    args.binaryInit = true;
+    args.size = config.getSize();
+    args.borderType = config.getBorderType();
+    args.openState = config.getOpenState();
+    args.rule = config.getRule();
+  }
+  // El tamaño es obligatorio salvo si lo da la cabecera de un archivo binario o la ventana de '-resume'
+  if (args.size == 0 && args.resumeWindow.empty()) {
+    std::cerr << "Tamaño del retículo no encontrado. Use '-size <n>'" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  // La configuración inicial aleatoria sustituye al archivo y solo la generan los retículos binarios
+  if (args.density >= 0 && (!args.filename.empty() || !args.resumeWindow.empty() || !args.convertFile.empty() ||
+                            args.states > 0 || !args.ensembleFile.empty() || args.ensembleRandom > 0)) {
+    std::cerr << "La opción '-random' no se puede usar con '-init', '-resume', '-convert', '-totalistic' ni '-ensemble'"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if (!args.convertFile.empty() && args.filename.empty()) {
+    std::cerr << "La opción '-convert' necesita '-init <file>'" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  // Las opciones del modo por lotes necesitan el número de generaciones
+  if (args.generations < 0 && (args.quiet || args.printEvery != 1)) {
+    std::cerr << "Las opciones '-print-every' y '-quiet' necesitan '-gens <n>'" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  // La cabecera PBM necesita saber cuántas generaciones hay
+  if (args.spacetimeFormat == PBM && !args.spacetimeFile.empty() && args.generations < 0) {
+    std::cerr << "La opción '-pbm' necesita '-gens <n>'" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  // Los hilos solo están disponibles en el retículo empaquetado y en el barrido de reglas
+  if (args.threads > 1 && !args.packed && args.sweepFile.empty()) {
+    std::cerr << "La opción '-threads' necesita '-packed' o '-sweep'" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  // El motor de macro-células trata el retículo como un anillo
+  if (args.jump >= 0 && (!args.packed || args.borderType != PERIODIC)) {
+    std::cerr << "La opción '-jump' necesita '-packed' y '-border periodic'" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  // Los saltos no pasan por todas las generaciones, así que no se pueden buscar ciclos con ellos
+  if (args.jump >= 0 && args.cycle) {
+    std::cerr << "Las opciones '-jump' y '-cycle' no se pueden usar a la vez" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  // Las teselas solo dejan la última de cada k generaciones, que es lo que necesitan el resto de opciones
+  if (args.block > 0 && (!args.packed || args.jump >= 0 || args.cycle || !args.densityFile.empty())) {
+    std::cerr << "La opción '-block' necesita '-packed' y no se puede usar con '-jump', '-cycle' ni '-density'" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  // Las consultas del cono de luz no evolucionan el retículo, así que no admiten opciones de evolución
+  if (!args.stateAt.empty()) {
+    if (!args.packed || args.generations >= 0 || args.threads > 1 || args.jump >= 0 || args.block > 0 ||
+        args.cycle || !args.densityFile.empty() || !args.spacetimeFile.empty()) {
+      std::cerr << "La opción '-state-at' necesita '-packed' y solo se puede combinar con '-size', '-border', "
+                << "'-init', '-rule' y '-simd'" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    for (const auto& query : args.stateAt) {
+      if (query.first >= args.size) {
+        std::cerr << "La posición " << query.first << " está fuera del retículo" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    }
+  }
+  // La propagación del daño evoluciona sus propios gemelos, no el retículo
+  if (args.damage >= 0) {
+    if (!args.packed || args.generations < 0) {
+      std::cerr << "La opción '-damage' necesita '-packed' y '-gens <n>'" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (args.threads > 1 || args.jump >= 0 || args.block > 0 || args.cycle || args.quiet || args.printEvery != 1 ||
+        !args.densityFile.empty() || !args.spacetimeFile.empty() || !args.stateAt.empty() || args.history > 0 ||
+        !args.sweepFile.empty()) {
+      std::cerr << "La opción '-damage' solo se puede combinar con '-size', '-border', '-init', '-rule', '-packed', "
+                << "'-simd' y '-gens'" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (args.damage >= args.size) {
+      std::cerr << "La posición " << args.damage << " está fuera del retículo" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+  // Al volver atrás con el historial se repetirían generaciones en la densidad, los ciclos y el diagrama
+  if (args.history > 0) {
+    if (args.jump >= 0 || args.cycle || !args.densityFile.empty() || !args.spacetimeFile.empty() ||
+        !args.stateAt.empty() || !args.streamFile.empty() || !args.ensembleFile.empty() || args.ensembleRandom > 0) {
+      std::cerr << "La opción '-history' no se puede usar con '-jump', '-cycle', '-density', '-pbm', '-rawbits', "
+                << "'-state-at', '-stream' ni '-ensemble'" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (!args.rowAt.empty() && args.generations < 0) {
+      std::cerr << "La opción '-row-at' necesita '-gens <n>'" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  } else if (args.keyframe != 64 || args.rawKeyframes || !args.rowAt.empty()) {
+    std::cerr << "Las opciones '-keyframe', '-raw-keyframes' y '-row-at' necesitan '-history <MiB>'" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  // El flujo de columnas tiene su propia ventana sobre una línea infinita
+  if (!args.streamFile.empty()) {
+    if (args.generations < 0) {
+      std::cerr << "La opción '-stream' necesita '-gens <n>'" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (args.packed || args.threads > 1 || args.jump >= 0 || args.block > 0 || args.cycle || args.quiet ||
+        args.printEvery != 1 || !args.densityFile.empty() || !args.spacetimeFile.empty() ||
+        !args.stateAt.empty() || !args.ensembleFile.empty() || args.ensembleRandom > 0) {
+      std::cerr << "La opción '-stream' solo se puede combinar con '-size', '-border', '-init', '-rule', '-simd', "
+                << "'-gens', '-columns', '-save-window' y '-resume'" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  } else if (!args.columns.empty() || !args.saveWindow.empty() || !args.resumeWindow.empty()) {
+    std::cerr << "Las opciones '-columns', '-save-window' y '-resume' necesitan '-stream <file|->'" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  // El retículo totalista tiene su propio paso y guarda más de un bit por célula
+  if (args.states > 0) {
+    if (args.binaryInit || args.packed || args.threads > 1 || args.jump >= 0 || args.block > 0 ||
+        !args.stateAt.empty() || !args.streamFile.empty() || args.history > 0 || !args.sweepFile.empty() ||
+        !args.ensembleFile.empty() || args.ensembleRandom > 0 || !args.convertFile.empty()) {
+      std::cerr << "La opción '-totalistic' no se puede usar con una configuración inicial binaria ni con "
+                << "'-convert', '-packed', '-threads', '-jump', '-block', '-state-at', '-stream', '-history', "
+                << "'-sweep' ni '-ensemble'" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (args.borderType == REFLECTIVE && args.radius > args.size) {
+      std::cerr << "Con la frontera reflectora el radio no puede ser mayor que el tamaño del retículo" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+  // El barrido evoluciona un retículo por regla y solo guarda sus estadísticas
+  if (!args.sweepFile.empty()) {
+    if (args.generations < 0) {
+      std::cerr << "La opción '-sweep' necesita '-gens <n>'" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (args.jump >= 0 || args.block > 0 || args.cycle || args.quiet || args.printEvery != 1 ||
+        !args.densityFile.empty() || !args.spacetimeFile.empty() || !args.stateAt.empty() ||
+        !args.streamFile.empty() || args.history > 0 || !args.ensembleFile.empty() || args.ensembleRandom > 0) {
+      std::cerr << "La opción '-sweep' solo se puede combinar con '-size', '-border', '-init', '-packed', '-simd', "
+                << "'-threads', '-gens' y '-rules'" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  } else if (!args.rules.empty()) {
+    std::cerr << "La opción '-rules' necesita '-sweep <file.csv>'" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  // El conjunto de simulaciones tiene su propio retículo y solo admite el modo por lotes
+  if (!args.ensembleFile.empty() || args.ensembleRandom > 0) {
+    if (args.generations < 0) {
+      std::cerr << "La opción '-ensemble' necesita '-gens <n>'" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (args.packed || !args.filename.empty() || args.threads > 1 || args.jump >= 0 || args.cycle ||
+        !args.densityFile.empty() || !args.spacetimeFile.empty()) {
+      std::cerr << "La opción '-ensemble' solo se puede combinar con '-size', '-border', '-rule', '-simd', "
+                << "'-gens', '-quiet' y '-seed'" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
 }
 
 /**
@@ -116,20 +678,455 @@ void checkArgs(int argc, char* argv[], int& size, BorderType& borderType, std::s
  * Se encarga de evolucionar el autómata celular.
  * La simulación se puede detener en cualquier momento pulsando un carácter elegido como fin de ejecución.
  * En este caso, se detiene la simulación si el usuario pulsa la tecla 'q'.
+ * Sirve tanto para Lattice como para PackedLattice.
  * @param lattice reticulo a evolucionar 
+ * @param writer escritor del diagrama espacio-tiempo, nullptr si no se guarda
+ * @param stride generaciones que se avanzan cada vez que se pulsa 'Enter'
  */
-void CellEvolution(Lattice& lattice) {
-  unsigned iteration = 0;
+template <typename LatticeType>
+void CellEvolution(LatticeType& lattice, SpacetimeWriter* writer, const long& stride) {
+  long iteration = 0;
   char user_input;
   std::cout << "Press 'q' to quit or 'Enter' to continue: ";
   do {
-    std::cout << lattice << "Iteration: " << iteration++ << std::endl;
-    lattice.NextGeneration();
+    std::cout << lattice << "Iteration: " << iteration << std::endl;
+    iteration += stride;
+    std::cout << "Número de células vivas: " << lattice.CountAliveCells() << std::endl;
+    if (writer != nullptr) {
+      writer->WriteRow(lattice);
+    }
+    lattice.Evolve(stride);
     user_input = std::cin.get();
     // mientras que el usuario no pulse la tecla 'q' se sigue evolucionando
   } while (user_input != 'q');
 }
 
+/**
+ * @brief Función que evoluciona el autómata celular con historial, pudiendo volver atrás
+ * Cada línea que escribe el usuario es una orden: vacía avanza stride generaciones, 'b' retrocede
+ * stride generaciones, 'g <n>' va a la generación n y 'q' termina. Las generaciones anteriores se
+ * reconstruyen desde el fotograma clave más cercano, sin volver a evolucionar desde la generación 0.
+ * Sirve tanto para Lattice como para PackedLattice.
+ * @param lattice reticulo a evolucionar
+ * @param history historial de fotogramas clave
+ * @param stride generaciones que se avanzan o retroceden con cada orden
+ */
+template <typename LatticeType>
+void ScrubEvolution(LatticeType& lattice, History& history, const long& stride) {
+  std::string command;
+  history.Record(lattice);
+  std::cout << "Press 'q' to quit, 'Enter' to continue, 'b' to go back or 'g <n>' to go to generation n: ";
+  while (true) {
+    std::cout << lattice << "Iteration: " << lattice.getGeneration() << std::endl;
+    std::cout << "Número de células vivas: " << lattice.CountAliveCells() << std::endl;
+    if (!std::getline(std::cin, command) || command == "q") {
+      break;
+    }
+    long target = lattice.getGeneration() + stride;
+    if (command == "b") {
+      target = std::max(lattice.getGeneration() - stride, 0L);
+    } else if (!command.empty() && command[0] == 'g') {
+      std::istringstream value{command.substr(1)};
+      if (!(value >> target) || target < 0) {
+        std::cout << "Generación no válida. Use 'g <n>'" << std::endl;
+        continue;
+      }
+    }
+    history.Seek(lattice, target);
+  }
+}
+
+/**
+ * @brief Función que evoluciona el autómata celular sin interacción con el usuario (modo por lotes)
+ * Evoluciona el número de generaciones indicado y, salvo en modo silencioso, imprime el retículo
+ * cada printEvery generaciones. La salida se acumula en un buffer y se escribe en bloques grandes.
+ * Entre dos impresiones las generaciones se evolucionan de una vez con Evolve, así que con varios
+ * hilos estos solo se sincronizan en la barrera de cada generación. Si se guarda el diagrama
+ * espacio-tiempo, se evoluciona de una en una para escribir todas las generaciones.
+ * Si se buscan ciclos, en cuanto se detecta uno se deja de evolucionar y se salta a la última
+ * generación con FastForward (salvo si se guarda el diagrama, que necesita todas las filas).
+ * Si hay historial, se evoluciona a través de él para que guarde los fotogramas clave.
+ * Al final se imprime un resumen con el tiempo, las generaciones por segundo y la población final.
+ * Las generaciones por segundo solo cuentan las calculadas, no las que se saltan con el ciclo.
+ * Sirve tanto para Lattice como para PackedLattice.
+ * @param lattice reticulo a evolucionar
+ * @param args argumentos del programa
+ * @param writer escritor del diagrama espacio-tiempo, nullptr si no se guarda
+ * @param history historial de fotogramas clave, nullptr si no se guarda
+ */
+template <typename LatticeType>
+void BatchEvolution(LatticeType& lattice, const Arguments& args, SpacetimeWriter* writer, History* history) {
+  // Tamaño a partir del cual se vuelca el buffer de salida
+  const std::streamoff kFlushBytes = 1 << 20;
+  std::ostringstream buffer;
+  const auto start = std::chrono::steady_clock::now();
+  // En modo silencioso no hay impresiones intermedias y se evoluciona todo de una vez
+  long step = args.quiet ? std::max(args.generations, 1L) : args.printEvery;
+  if (writer != nullptr) {
+    step = 1;
+  }
+  // Última generación impresa, para no repetirla al terminar
+  long printed = -1;
+  // Generaciones calculadas de verdad: al detectar un ciclo, las demás se saltan
+  long computed = args.generations;
+  for (long iteration = 0; iteration <= args.generations; iteration += step) {
+    if (!args.quiet && (iteration % args.printEvery == 0 || iteration == args.generations)) {
+      buffer << lattice << "Iteration: " << iteration << '\n';
+      printed = iteration;
+      if (buffer.tellp() > kFlushBytes) {
+        std::cout << buffer.str();
+        buffer.str("");
+      }
+    }
+    if (writer != nullptr) {
+      writer->WriteRow(lattice);
+    }
+    if (history != nullptr) {
+      history->Advance(lattice, std::min(step, args.generations - iteration));
+    } else {
+      lattice.Evolve(std::min(step, args.generations - iteration));
+    }
+    if (writer == nullptr && lattice.getCycles().Found()) {
+      const long detected = lattice.getGeneration();
+      lattice.FastForward(args.generations);
+      computed = detected + (args.generations - detected) % lattice.getCycles().getPeriod();
+      break;
+    }
+  }
+  if (!args.quiet && printed != args.generations) {
+    buffer << lattice << "Iteration: " << args.generations << '\n';
+  }
+  // El tiempo incluye terminar de escribir el diagrama
+  if (writer != nullptr) {
+    writer->Close();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  std::cout << buffer.str();
+  const double seconds = std::chrono::duration<double>(end - start).count();
+  const double generationsPerSecond = seconds > 0 ? computed / seconds : 0;
+  std::cout << "Generations: " << args.generations << '\n';
+  if (computed < args.generations) {
+    std::cout << "Generations computed: " << computed << " (the rest skipped with the cycle)" << '\n';
+  }
+  std::cout << "Wall time: " << seconds << " s" << '\n';
+  std::cout << "Generations per second: " << generationsPerSecond << '\n';
+  std::cout << "Cell updates per second: " << generationsPerSecond * args.size << '\n';
+  std::cout << "Final population: " << lattice.CountAliveCells() << std::endl;
+  if (args.cycle) {
+    const CycleDetector& cycles = lattice.getCycles();
+    if (cycles.Found()) {
+      std::cout << "Transient length: " << cycles.getTransient() << '\n';
+      std::cout << "Cycle period: " << cycles.getPeriod() << (cycles.getPeriod() == 1 ? " (fixed point)" : "") << '\n';
+    } else if (cycles.Exhausted()) {
+      std::cout << "Cycle: not detected in the first " << CycleDetector::kMaxHistory << " generations (history limit)" << '\n';
+    } else {
+      std::cout << "Cycle: not detected" << '\n';
+    }
+  }
+  if (history != nullptr) {
+    std::cout << "Keyframes: " << history->getKeyframes() << " every " << history->getInterval()
+              << " generations (" << history->getBytes() << " bytes)" << std::endl;
+  }
+}
+
+/**
+ * @brief Función que evoluciona un conjunto de simulaciones en el modo por lotes
+ * Todas las simulaciones avanzan a la vez las generaciones indicadas. Al final se imprime la población
+ * de cada simulación (salvo en modo silencioso) y un resumen en el que las células actualizadas por
+ * segundo cuentan las de todas las simulaciones.
+ * @param lattice conjunto de simulaciones
+ * @param args argumentos del programa
+ */
+void EnsembleEvolution(EnsembleLattice& lattice, const Arguments& args) {
+  const auto start = std::chrono::steady_clock::now();
+  lattice.Evolve(args.generations);
+  const std::vector<std::size_t> populations = lattice.Populations();
+  const auto end = std::chrono::steady_clock::now();
+  std::ostringstream buffer;
+  std::size_t total = 0;
+  for (std::size_t simulation = 0; simulation < populations.size(); ++simulation) {
+    if (!args.quiet) {
+      buffer << "Simulation " << simulation << ": " << populations[simulation] << '\n';
+    }
+    total += populations[simulation];
+  }
+  std::cout << buffer.str();
+  const double seconds = std::chrono::duration<double>(end - start).count();
+  const double generationsPerSecond = seconds > 0 ? args.generations / seconds : 0;
+  std::cout << "Simulations: " << lattice.getSimulations() << '\n';
+  std::cout << "Generations: " << args.generations << '\n';
+  std::cout << "Wall time: " << seconds << " s" << '\n';
+  std::cout << "Generations per second: " << generationsPerSecond << '\n';
+  std::cout << "Cell updates per second: " << generationsPerSecond * args.size * lattice.getSimulations() << '\n';
+  std::cout << "Mean final density: " << static_cast<double>(total) / (static_cast<double>(args.size) * lattice.getSimulations()) << std::endl;
+}
+
+/**
+ * @brief Función que escribe el flujo de bits de las columnas
+ * En cada generación se toma el bit de cada columna, en orden, y se empaquetan 8 bits por byte
+ * empezando por el más significativo. Los bytes se acumulan en un buffer y se escriben en bloques de
+ * 1 MiB. El último byte se completa con ceros, así que para concatenar flujos continuados con
+ * '-resume' el número de bits (generaciones por columnas) tiene que ser múltiplo de 8.
+ * El resumen va a la salida de error si el flujo va a la salida estándar.
+ * @param stream ventana del flujo, en la generación desde la que se emite
+ * @param args argumentos del programa
+ */
+void StreamColumns(ColumnStream& stream, const Arguments& args) {
+  const std::size_t kBufferBytes = 1 << 20;
+  if (!args.columns.empty()) {
+    stream.setColumns(args.columns);
+  }
+  stream.setSimdLevel(args.simdLevel);
+  std::ofstream output_file;
+  if (args.streamFile != "-") {
+    output_file.open(args.streamFile, std::ios::binary);
+    if (!output_file.is_open()) {
+      std::cerr << "Unable to open file " << args.streamFile << " for saving." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+  std::ostream& output = args.streamFile == "-" ? std::cout : output_file;
+  std::vector<char> buffer;
+  buffer.reserve(kBufferBytes);
+  std::size_t bytes = 0;
+  uint8_t byte = 0;
+  int bits = 0;
+  const long first = stream.getGeneration();
+  const auto start = std::chrono::steady_clock::now();
+  for (long generation = 0; generation < args.generations; ++generation) {
+    for (const long& column : stream.getColumns()) {
+      byte = (byte << 1) | stream.getState(column);
+      if (++bits == 8) {
+        buffer.push_back(byte);
+        byte = 0;
+        bits = 0;
+        if (buffer.size() == kBufferBytes) {
+          output.write(buffer.data(), buffer.size());
+          bytes += buffer.size();
+          buffer.clear();
+        }
+      }
+    }
+    stream.NextGeneration();
+  }
+  if (bits > 0) {
+    buffer.push_back(byte << (8 - bits));
+  }
+  output.write(buffer.data(), buffer.size());
+  output.flush();
+  bytes += buffer.size();
+  const auto end = std::chrono::steady_clock::now();
+  const double seconds = std::chrono::duration<double>(end - start).count();
+  std::ostream& report = args.streamFile == "-" ? std::cerr : std::cout;
+  report << "Generations: " << first << " to " << stream.getGeneration() - 1 << '\n';
+  report << "Bits: " << args.generations * stream.getColumns().size() << " (" << bytes << " bytes)" << '\n';
+  report << "Wall time: " << seconds << " s" << '\n';
+  report << "Throughput: " << (seconds > 0 ? bytes / seconds / 1e6 : 0) << " MB/s" << '\n';
+  report << "Final window: " << stream.getWidth() << " cells" << std::endl;
+  if (!args.saveWindow.empty()) {
+    stream.Save(args.saveWindow);
+  }
+}
+
+/**
+ * @brief Función que hace el barrido de reglas
+ * Evoluciona la configuración inicial del retículo con cada regla, guarda el CSV e imprime un resumen
+ * en el que las células actualizadas por segundo solo cuentan las generaciones calculadas: las reglas
+ * que llegan a un ciclo se saltan el resto.
+ * @param lattice retículo empaquetado con la configuración inicial y la frontera
+ * @param args argumentos del programa
+ */
+void SweepRules(const PackedLattice& lattice, const Arguments& args) {
+  std::vector<int> rules = args.rules;
+  if (rules.empty()) {
+    for (int rule = 0; rule < 256; ++rule) {
+      rules.push_back(rule);
+    }
+  }
+  RuleSweep sweep(lattice, args.generations);
+  sweep.setSimdLevel(args.simdLevel);
+  const auto start = std::chrono::steady_clock::now();
+  sweep.Run(rules, args.threads);
+  const auto end = std::chrono::steady_clock::now();
+  sweep.Save(args.sweepFile);
+  std::size_t cycles = 0;
+  double computed = 0;
+  for (const RuleStats& stats : sweep.getStats()) {
+    cycles += stats.period > 0;
+    computed += stats.computed;
+  }
+  const double seconds = std::chrono::duration<double>(end - start).count();
+  std::cout << "Rules: " << rules.size() << " (" << cycles << " with a cycle)" << '\n';
+  std::cout << "Generations: " << args.generations << " per rule (" << computed << " computed in total)" << '\n';
+  std::cout << "Wall time: " << seconds << " s" << '\n';
+  std::cout << "Cell updates per second: " << (seconds > 0 ? computed * args.size / seconds : 0) << '\n';
+  std::cout << "Saved to " << args.sweepFile << std::endl;
+}
+
+/**
+ * @brief Función que guarda la serie temporal de densidad en un archivo
+ * Cada línea tiene el número de generación y la densidad de esa generación.
+ * @param density serie temporal de densidad
+ * @param filename nombre del archivo de salida
+ */
+void SaveDensity(const std::vector<double>& density, const std::string& filename) {
+  std::ofstream output_file{filename};
+  if (!output_file.is_open()) {
+    std::cerr << "Unable to open file " << filename << " for saving." << std::endl;
+    return;
+  }
+  for (std::size_t generation = 0; generation < density.size(); ++generation) {
+    output_file << generation << ' ' << density[generation] << '\n';
+  }
+}
+
+/**
+ * @brief Función que elige entre la evolución interactiva y el modo por lotes
+ * @param lattice reticulo a evolucionar
+ * @param args argumentos del programa
+ */
+template <typename LatticeType>
+void Run(LatticeType& lattice, const Arguments& args) {
+  lattice.setRecordDensity(!args.densityFile.empty());
+  lattice.setCycleDetection(args.cycle);
+  std::unique_ptr<SpacetimeWriter> writer;
+  if (!args.spacetimeFile.empty()) {
+    const long rows = args.generations + 1;
+    writer.reset(new SpacetimeWriter(args.spacetimeFile, args.spacetimeFormat, args.size, rows));
+  }
+  std::unique_ptr<History> history;
+  if (args.history > 0) {
+    history.reset(new History(args.size, args.history << 20, args.keyframe, !args.rawKeyframes));
+  }
+  if (args.generations >= 0) {
+    BatchEvolution(lattice, args, writer.get(), history.get());
+    // Las generaciones pedidas se reconstruyen desde el historial, después del resumen
+    for (const long& generation : args.rowAt) {
+      history->Restore(lattice, generation);
+      std::cout << lattice << "Iteration: " << generation << std::endl;
+    }
+  } else if (history != nullptr) {
+    ScrubEvolution(lattice, *history, 1);
+  } else {
+    CellEvolution(lattice, writer.get(), args.jump >= 0 ? 1L << args.jump : 1);
+  }
+  if (!args.densityFile.empty()) {
+    SaveDensity(lattice.getDensity(), args.densityFile);
+  }
+}
+
+/**
+ * @brief Función que responde a las consultas del cono de luz
+ * Para cada célula pedida se imprime su estado en la generación indicada y el tiempo que ha costado.
+ * El retículo no cambia, así que todas las consultas parten de la configuración inicial.
+ * @param lattice reticulo empaquetado
+ * @param args argumentos del programa
+ */
+void QueryStates(const PackedLattice& lattice, const Arguments& args) {
+  for (const auto& query : args.stateAt) {
+    const auto start = std::chrono::steady_clock::now();
+    const State state = lattice.StateAt(query.first, query.second);
+    const auto end = std::chrono::steady_clock::now();
+    std::cout << "Cell " << query.first << " at generation " << query.second << ": " << state
+              << " (" << std::chrono::duration<double>(end - start).count() << " s)" << '\n';
+  }
+}
+
+/**
+ * @brief Función que analiza la propagación del daño
+ * Guarda una línea por generación con la generación, el número de células distintas entre el
+ * retículo y su gemelo y la primera y la última de ellas, como desplazamiento desde la célula cambiada
+ * ('-' si ya no hay ninguna), e imprime un resumen con el tiempo que ha costado.
+ * @param lattice reticulo empaquetado
+ * @param args argumentos del programa
+ */
+void SpreadDamage(const PackedLattice& lattice, const Arguments& args) {
+  const auto start = std::chrono::steady_clock::now();
+  const std::vector<Damage> damage = lattice.SpreadDamage(args.damage, args.generations);
+  const auto end = std::chrono::steady_clock::now();
+  std::ofstream output_file{args.damageFile};
+  if (!output_file.is_open()) {
+    std::cerr << "Unable to open file " << args.damageFile << " for saving." << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  std::size_t maximum = 0;
+  for (std::size_t generation = 0; generation < damage.size(); ++generation) {
+    output_file << generation << ' ' << damage[generation].distance;
+    if (damage[generation].distance > 0) {
+      output_file << ' ' << damage[generation].left << ' ' << damage[generation].right << '\n';
+    } else {
+      output_file << " - -" << '\n';
+    }
+    maximum = std::max(maximum, damage[generation].distance);
+  }
+  const Damage& last = damage.back();
+  const double seconds = std::chrono::duration<double>(end - start).count();
+  std::cout << "Final distance: " << last.distance << '\n';
+  std::cout << "Maximum distance: " << maximum << '\n';
+  if (last.distance > 0) {
+    std::cout << "Final front: " << last.left << ' ' << last.right << '\n';
+  } else {
+    std::cout << "Final front: none, the damage has healed" << '\n';
+  }
+  std::cout << "Generations: " << args.generations << '\n';
+  std::cout << "Wall time: " << seconds << " s" << '\n';
+  std::cout << "Generations per second: " << (seconds > 0 ? args.generations / seconds : 0) << '\n';
+  std::cout << "Saved to " << args.damageFile << std::endl;
+}
+
+/**
+ * @brief Función que prepara el retículo empaquetado con las opciones del programa y lo evoluciona
+ * Si solo se consultan células con el cono de luz o se analiza la propagación del daño, no se evoluciona.
+ * @param lattice reticulo empaquetado
+ * @param args argumentos del programa
+ */
+void RunPacked(PackedLattice& lattice, const Arguments& args) {
+  lattice.setSimdLevel(args.simdLevel);
+  if (!args.stateAt.empty()) {
+    QueryStates(lattice, args);
+    return;
+  }
+  if (args.damage >= 0) {
+    SpreadDamage(lattice, args);
+    return;
+  }
+  lattice.setThreads(args.threads);
+  lattice.setJump(args.jump);
+  lattice.setTemporalBlocking(args.block);
+  Run(lattice, args);
+}
+
+/**
+ * @brief Función que crea el retículo empaquetado con una configuración inicial aleatoria
+ * Las palabras se generan con los hilos de '-threads'. Con la misma semilla sale la misma
+ * configuración, sea cual sea el número de hilos.
+ * @param args argumentos del programa
+ * @return PackedLattice retículo empaquetado con la configuración aleatoria
+ */
+PackedLattice RandomLattice(const Arguments& args) {
+  PackedLattice lattice(args.size, args.borderType, args.openState, args.rule);
+  lattice.setThreads(args.threads);
+  lattice.Randomize(args.density, args.seed);
+  return lattice;
+}
+
+/**
+ * @brief Función que convierte la configuración inicial al formato binario empaquetado
+ * Se carga con el retículo empaquetado (que ya lee el formato de texto) y se guardan sus células.
+ * @param args argumentos del programa
+ */
+void ConvertToBinary(const Arguments& args) {
+  std::vector<uint8_t> cells((static_cast<std::size_t>(args.size) + 7) / 8);
+  if (args.binaryInit) {
+    const BinaryConfig config(args.filename);
+    PackedLattice(config).PackRow(cells.data(), false);
+  } else {
+    PackedLattice(args.size, args.borderType, args.openState, args.rule, args.filename).PackRow(cells.data(), false);
+  }
+  SaveBinaryConfig(args.convertFile, args.size, args.borderType, args.openState, args.rule, cells.data());
+  std::cout << "Saved " << args.size << " cells to " << args.convertFile << std::endl;
+}
+
 /**
  * @brief Programa principal main
  * Aquí se recibe por línea de comandos el tamaño del retículo, el tipo de frontera y el archivo de configuración inicial
@@ -142,28 +1139,111 @@ void CellEvolution(Lattice& lattice) {
 int main(int argc, char* argv[]) {
   // Utilización del programa
   Usage(argc, argv);
-  int size;
-  BorderType borderType;
-  std::string borderType_aux{argv[4]};
-  std::string filename;
-  // Asignamos el tipo de frontera
-  if (borderType_aux == "open") {
-    borderType = OPEN;
-  } else if (borderType_aux == "periodic") {
-    borderType = PERIODIC;
-  } else if (borderType_aux == "reflective") {
-    borderType = REFLECTIVE;
-  }
+  Arguments args;
   // Comprobamos los argumentos
-  checkArgs(argc, argv, size, borderType, filename);
+  checkArgs(argc, argv, args);
+  // Si se pide la conversión al formato binario, no se evoluciona
+  if (!args.convertFile.empty()) {
+    ConvertToBinary(args);
+    return 0;
+  }
+  // Si se pide el flujo de columnas, se crea desde una ventana guardada o desde la configuración inicial
+  if (!args.streamFile.empty()) {
+    if (!args.resumeWindow.empty()) {
+      ColumnStream stream(args.resumeWindow);
+      StreamColumns(stream, args);
+    } else if (args.density >= 0) {
+      ColumnStream stream(RandomLattice(args));
+      StreamColumns(stream, args);
+    } else if (args.filename.empty()) {
+      ColumnStream stream(PackedLattice(args.size, args.borderType, args.openState, args.rule));
+      StreamColumns(stream, args);
+    } else if (args.binaryInit) {
+      const BinaryConfig config(args.filename);
+      ColumnStream stream(PackedLattice{config});
+      StreamColumns(stream, args);
+    } else {
+      ColumnStream stream(PackedLattice(args.size, args.borderType, args.openState, args.rule, args.filename));
+      StreamColumns(stream, args);
+    }
+    return 0;
+  }
+  // Si se pide el barrido de reglas, la configuración inicial se carga una vez en un retículo empaquetado
+  if (!args.sweepFile.empty()) {
+    if (args.density >= 0) {
+      SweepRules(RandomLattice(args), args);
+    } else if (args.filename.empty()) {
+      SweepRules(PackedLattice(args.size, args.borderType, args.openState, args.rule), args);
+    } else if (args.binaryInit) {
+      const BinaryConfig config(args.filename);
+      SweepRules(PackedLattice(config), args);
+    } else {
+      SweepRules(PackedLattice(args.size, args.borderType, args.openState, args.rule, args.filename), args);
+    }
+    return 0;
+  }
+  // Si se pide un conjunto de simulaciones, se crea desde el archivo o con configuraciones aleatorias
+  if (!args.ensembleFile.empty() || args.ensembleRandom > 0) {
+    if (args.ensembleFile.empty()) {
+      EnsembleLattice lattice(args.size, args.borderType, args.openState, args.rule, args.ensembleRandom, args.seed);
+      lattice.setSimdLevel(args.simdLevel);
+      EnsembleEvolution(lattice, args);
+    } else {
+      EnsembleLattice lattice(args.size, args.borderType, args.openState, args.rule, args.ensembleFile);
+      lattice.setSimdLevel(args.simdLevel);
+      EnsembleEvolution(lattice, args);
+    }
+  // Si se pide una regla totalista, se crea su retículo con o sin archivo de configuración inicial
+  } else if (args.states > 0) {
+    if (args.filename.empty()) {
+      TotalisticLattice lattice(args.size, args.borderType, args.openState, args.states, args.radius, args.totalisticCode);
+      lattice.setSimdLevel(args.simdLevel);
+      Run(lattice, args);
+    } else {
+      TotalisticLattice lattice(args.size, args.borderType, args.openState, args.states, args.radius, args.totalisticCode,
+                                args.filename);
+      lattice.setSimdLevel(args.simdLevel);
+      Run(lattice, args);
+    }
+  // Si se pide el retículo empaquetado, se crea con o sin archivo de configuración inicial
+  } else if (args.packed) {
+    if (args.density >= 0) {
+      PackedLattice lattice = RandomLattice(args);
+      RunPacked(lattice, args);
+    } else if (args.filename.empty()) {
+      PackedLattice lattice(args.size, args.borderType, args.openState, args.rule);
+      RunPacked(lattice, args);
+    } else if (args.binaryInit) {
+      const BinaryConfig config(args.filename);
+      PackedLattice lattice(config);
+      RunPacked(lattice, args);
+    } else {
+      PackedLattice lattice(args.size, args.borderType, args.openState, args.rule, args.filename);
+      RunPacked(lattice, args);
+    }
+  // Si la configuración inicial es aleatoria, se genera empaquetada y se carga en el retículo
+  } else if (args.density >= 0) {
+    Lattice lattice(args.size, args.borderType, args.openState);
+    lattice.setRule(args.rule);
+    std::vector<uint8_t> cells((static_cast<std::size_t>(args.size) + 7) / 8);
+    RandomLattice(args).PackRow(cells.data(), false);
+    lattice.LoadRow(cells.data(), 0);
+    Run(lattice, args);
   // Si el archivo de configuración inicial está vacío, se crea el retículo sin él
-  if (filename.empty()) {
-    Lattice lattice(size, borderType, argv);
-    CellEvolution(lattice);
+  } else if (args.filename.empty()) {
+    Lattice lattice(args.size, args.borderType, args.openState);
+    lattice.setRule(args.rule);
+    Run(lattice, args);
+  // Si el archivo de configuración inicial es binario, se crea el retículo con su cabecera y sus células
+  } else if (args.binaryInit) {
+    const BinaryConfig config(args.filename);
+    Lattice lattice(config);
+    Run(lattice, args);
   // Si el archivo de configuración inicial no está vacío, se crea el retículo con él
   } else {
-    Lattice lattice(size, borderType, filename, argv);
-    CellEvolution(lattice);
+    Lattice lattice(args.size, args.borderType, args.openState, args.filename);
+    lattice.setRule(args.rule);
+    Run(lattice, args);
   }
   std::cout << "Ending simulation." << std::endl;
   return 0;
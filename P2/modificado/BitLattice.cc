@@ -0,0 +1,360 @@
+/**
+ * ************ PRÁCTICA 2 *************
+ * @file BitLattice.cc
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-22
+ * @brief Implementación de los métodos de la clase BitLattice.
+ * Encontramos los constructores, el acceso a las células, el relleno de las filas y columnas fantasma
+ * según la frontera, la selección de las teselas activas, los métodos que evolucionan el autómata
+ * celular palabra a palabra, con uno o varios hilos, y la sobrecarga del operador de salida.
+ */
+
+#include "BitLattice.h"
+
+/**
+ * @brief Función que cambia el bit de una columna de una fila.
+ * Las columnas -1 y -2 están en la palabra anterior a la de la columna 0.
+ * @param row palabra de la columna 0 de la fila
+ * @param column columna, de -2 a N + 1
+ * @param state estado nuevo
+ */
+static void SetBit(uint64_t* row, const int& column, const State& state) {
+  uint64_t& word = row[(column + 64) / 64 - 1];
+  const uint64_t bit = 1ULL << ((column + 64) % 64);
+  word = state ? (word | bit) : (word & ~bit);
+}
+
+/**
+ * @brief Construct a new BitLattice:: BitLattice object
+ * Igual que Lattice, se pide por teclado el estado inicial de cada célula.
+ * @param rows número de filas
+ * @param columns número de columnas
+ * @param border tipo de frontera
+ * @param openState estado de las células fantasma si la frontera es abierta
+ */
+BitLattice::BitLattice(const int& rows, const int& columns, const BorderType& border, const State& openState)
+    : rows_(rows), columns_(columns), borderType_(border), openState_(openState) {
+  Allocate();
+  for (int i = 0; i < rows_; ++i) {
+    for (int j = 0; j < columns_; ++j) {
+      std::cout << "Ingrese el estado inicial (0 para muerta, 1 para viva) de la celda en la posición [" << i << ", " << j << "]: ";
+      int inputState;
+      std::cin >> inputState;
+      setState({i, j}, static_cast<State>(inputState));
+    }
+  }
+}
+
+/**
+ * @brief Construct a new BitLattice:: BitLattice object
+ * Se leen el número de filas, el de columnas y después el estado de cada célula (0 o 1), fila a fila.
+ * @param border tipo de frontera
+ * @param openState estado de las células fantasma si la frontera es abierta
+ * @param filename nombre del archivo de configuración inicial
+ */
+BitLattice::BitLattice(const BorderType& border, const State& openState, const std::string& filename)
+    : borderType_(border), openState_(openState) {
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    throw std::runtime_error("Could not open the file");
+  }
+  if (!(file >> rows_ >> columns_)) {
+    throw std::runtime_error("Error reading the number of rows and columns");
+  }
+  if (rows_ <= 0 || columns_ <= 0) {
+    throw std::runtime_error("The number of rows and columns must be greater than 0");
+  }
+  Allocate();
+  for (int i = 0; i < rows_; ++i) {
+    for (int j = 0; j < columns_; ++j) {
+      int cellState;
+      if (!(file >> cellState)) {
+        throw std::runtime_error("Error reading cell state");
+      }
+      setState({i, j}, (cellState == 1) ? ALIVE : DEAD);
+    }
+  }
+}
+
+/**
+ * @brief Método que reserva los buffers.
+ * Cada fila tiene una palabra de relleno a cada lado, y hay kGhost filas fantasma arriba y abajo.
+ * La frontera reflectora copia las filas y columnas 1 y 2, así que necesita al menos 3 de cada.
+ * Al principio todas las teselas cuentan como cambiadas, así que en la primera generación se calculan todas.
+ */
+void BitLattice::Allocate() {
+  if (borderType_ == NOFRONTER) {
+    throw std::runtime_error("The bit lattice does not support the 'noborder' border");
+  }
+  if (borderType_ == REFLECTIVE && (rows_ < 3 || columns_ < 3)) {
+    throw std::runtime_error("The reflective border needs at least 3 rows and 3 columns");
+  }
+  words_ = (static_cast<std::size_t>(columns_) + 63) / 64;
+  stride_ = words_ + 2;
+  tail_mask_ = (columns_ % 64 == 0) ? ~0ULL : ((1ULL << (columns_ % 64)) - 1);
+  current_.assign((rows_ + 2 * kGhost) * stride_, 0);
+  next_.assign(current_.size(), 0);
+  tile_rows_ = (rows_ + kTileRows - 1) / kTileRows;
+  changed_.assign(tile_rows_ * words_, 1);
+  active_.assign(changed_.size(), 0);
+  activity_.tiles = changed_.size();
+}
+
+/**
+ * @brief Método que devuelve el estado de la célula en la posición dada.
+ * @param position fila y columna de la célula
+ * @return State estado de la célula
+ */
+State BitLattice::getState(const Position& position) const {
+  return (Row(position.first)[position.second / 64] >> (position.second % 64)) & 1ULL;
+}
+
+/**
+ * @brief Setter que establece el estado de la célula en la posición dada.
+ * @param position fila y columna de la célula
+ * @param state estado nuevo de la célula
+ */
+void BitLattice::setState(const Position& position, const State& state) {
+  population_ += static_cast<std::size_t>(state) - getState(position);
+  SetBit(Row(current_.data(), position.first), position.second, state);
+  changed_[(position.first / kTileRows) * words_ + position.second / 64] = 1;
+}
+
+/**
+ * @brief Método que devuelve la fila o columna que se copia en una fantasma.
+ * Con frontera periódica es la del extremo contrario. Con frontera reflectora es la simétrica respecto
+ * a la primera o la última (la fantasma -1 copia la 1 y la -2, la 2), igual que Lattice::applyBorders.
+ * @param index fila o columna fantasma
+ * @param size número de filas o columnas
+ * @return int fila o columna del retículo
+ */
+int BitLattice::Source(const int& index, const int& size) const {
+  if (borderType_ == PERIODIC) {
+    return (index % size + size) % size;
+  }
+  return index < 0 ? -index : 2 * (size - 1) - index;
+}
+
+/**
+ * @brief Método que rellena las filas y columnas fantasma antes de calcular la siguiente generación.
+ * Con frontera abierta, todas tienen el estado fijo. Si no, las filas fantasma se copian palabra a
+ * palabra y las columnas fantasma, bit a bit. La vecindad es en cruz, así que las esquinas no se usan.
+ */
+void BitLattice::UpdateBorders() {
+  uint64_t* words = current_.data();
+  const int ghosts[] = {-2, -1, rows_, rows_ + 1};
+  for (const int& row : ghosts) {
+    if (borderType_ == OPEN) {
+      std::fill(Row(words, row), Row(words, row) + words_, openState_ ? ~0ULL : 0ULL);
+    } else {
+      std::memcpy(Row(words, row), Row(Source(row, rows_)), words_ * sizeof(uint64_t));
+    }
+  }
+  const int columns[] = {-2, -1, columns_, columns_ + 1};
+  for (int i = 0; i < rows_; ++i) {
+    uint64_t* row = Row(words, i);
+    for (const int& column : columns) {
+      const int source = Source(column, columns_);
+      SetBit(row, column, borderType_ == OPEN ? openState_ : static_cast<State>((row[source / 64] >> (source % 64)) & 1ULL));
+    }
+  }
+}
+
+/**
+ * @brief Función que evoluciona el autómata celular una generación.
+ * Se rellenan las fantasmas, se marcan las teselas activas, se calculan en el otro buffer y se
+ * intercambian. Las teselas que no se calculan no cambian, y en el otro buffer tienen la generación
+ * anterior, que es igual a la actual, así que no hace falta copiarlas.
+ * Si hay varios hilos, se usa Evolve para repartir el retículo entre ellos.
+ */
+void BitLattice::NextGeneration() {
+  if (pool_ != nullptr) {
+    Evolve(1);
+    return;
+  }
+  BeginGeneration();
+  population_ += StepRows(0, rows_);
+  current_.swap(next_);
+}
+
+/**
+ * @brief Método que prepara el cálculo de una generación.
+ * Rellena las fantasmas, marca las teselas activas y borra las marcas de cambio, que se vuelven a
+ * poner al calcular.
+ */
+void BitLattice::BeginGeneration() {
+  UpdateBorders();
+  MarkActive();
+  std::fill(changed_.begin(), changed_.end(), 0);
+}
+
+/**
+ * @brief Función que evoluciona el autómata celular varias generaciones.
+ * Con un solo hilo equivale a llamar a NextGeneration. Con varios, el retículo se divide en bandas de
+ * filas de teselas contiguas, una por hilo, así que cada marca de cambio la escribe un solo hilo. Cada
+ * hilo lee las dos filas de arriba y las dos de abajo de su banda (el halo) directamente del buffer
+ * compartido de la generación actual, que nadie modifica durante el cálculo. Al terminar cada
+ * generación los hilos se esperan en una barrera y el último en llegar suma las diferencias de
+ * población, intercambia los buffers y prepara la siguiente generación.
+ * @param generations número de generaciones
+ */
+void BitLattice::Evolve(const long& generations) {
+  if (pool_ == nullptr) {
+    for (long generation = 0; generation < generations; ++generation) {
+      NextGeneration();
+    }
+    return;
+  }
+  if (generations <= 0) {
+    return;
+  }
+  const std::size_t threads = pool_->getThreads();
+  const int band = (tile_rows_ + threads - 1) / threads * kTileRows;
+  std::vector<long> partial(threads, 0);
+  long finished = 0;
+  Barrier barrier(threads);
+  const auto completion = [this, &partial, &finished, &generations] {
+    for (const long& difference : partial) {
+      population_ += difference;
+    }
+    current_.swap(next_);
+    if (++finished < generations) {
+      BeginGeneration();
+    }
+  };
+  BeginGeneration();
+  pool_->Run([&](std::size_t id) {
+    const int begin = std::min(static_cast<int>(id) * band, rows_);
+    const int end = std::min(begin + band, rows_);
+    for (long generation = 0; generation < generations; ++generation) {
+      partial[id] = StepRows(begin, end);
+      barrier.ArriveAndWait(completion);
+    }
+  });
+}
+
+/**
+ * @brief Método que cambia el número de hilos con los que se evoluciona el retículo.
+ * Los hilos se crean una sola vez y se reutilizan en todas las generaciones.
+ * @param threads número de hilos, 1 para evolucionar en el hilo principal
+ */
+void BitLattice::setThreads(const std::size_t& threads) {
+  if (threads > 1) {
+    pool_.reset(new ThreadPool(threads));
+  } else {
+    pool_.reset();
+  }
+}
+
+/**
+ * @brief Método que marca las teselas que hay que calcular en esta generación.
+ * Una tesela es activa si cambió ella o alguna de sus cuatro vecinas. En los bordes, si la frontera no
+ * es abierta, también si cambió la tesela de la que se copian las filas o columnas fantasma que lee
+ * alguna de sus células, que con frontera periódica está en el extremo contrario.
+ */
+void BitLattice::MarkActive() {
+  const int columns = static_cast<int>(words_);
+  for (int r = 0; r < tile_rows_; ++r) {
+    for (int k = 0; k < columns; ++k) {
+      const std::size_t tile = r * words_ + k;
+      active_[tile] = changed_[tile] | (r > 0 && changed_[tile - words_]) | (r + 1 < tile_rows_ && changed_[tile + words_]) |
+                      (k > 0 && changed_[tile - 1]) | (k + 1 < columns && changed_[tile + 1]);
+    }
+  }
+  if (borderType_ != OPEN) {
+    // Una fantasma la leen las filas (o columnas) a distancia 1 y 2, que pueden caer en teselas distintas
+    const int ghosts[] = {-2, -1, rows_, rows_ + 1};
+    for (const int& row : ghosts) {
+      const int source = Source(row, rows_) / kTileRows;
+      for (int reader = std::max(row - 2, 0); reader <= std::min(row + 2, rows_ - 1); ++reader) {
+        const int target = reader / kTileRows;
+        for (int k = 0; k < columns; ++k) {
+          active_[target * words_ + k] |= changed_[source * words_ + k];
+        }
+      }
+    }
+    const int ghost_columns[] = {-2, -1, columns_, columns_ + 1};
+    for (const int& column : ghost_columns) {
+      const int source = Source(column, columns_) / 64;
+      for (int reader = std::max(column - 2, 0); reader <= std::min(column + 2, columns_ - 1); ++reader) {
+        const int target = reader / 64;
+        for (int r = 0; r < tile_rows_; ++r) {
+          active_[r * words_ + target] |= changed_[r * words_ + source];
+        }
+      }
+    }
+  }
+  activity_.active = std::count(active_.begin(), active_.end(), 1);
+  activity_.evaluated += activity_.active;
+  activity_.skipped += activity_.tiles - activity_.active;
+}
+
+/**
+ * @brief Método que calcula las teselas activas de las filas [begin, end) de la siguiente generación.
+ * Cada palabra se calcula con CrossRule a partir de sus vecinas de la misma fila y de las palabras de
+ * las dos filas de arriba y las dos de abajo, que en los extremos son filas fantasma. Si es distinta de
+ * la actual, su tesela queda marcada como cambiada.
+ * @param begin primera fila
+ * @param end fila siguiente a la última
+ * @return long diferencia entre las células vivas de esas filas en la siguiente generación y en la actual
+ */
+long BitLattice::StepRows(const int& begin, const int& end) {
+  long population = 0;
+  for (int i = begin; i < end; ++i) {
+    const uint8_t* active = active_.data() + (i / kTileRows) * words_;
+    uint8_t* changed = changed_.data() + (i / kTileRows) * words_;
+    const uint64_t* up2 = Row(i - 2);
+    const uint64_t* up1 = Row(i - 1);
+    const uint64_t* center = Row(i);
+    const uint64_t* down1 = Row(i + 1);
+    const uint64_t* down2 = Row(i + 2);
+    uint64_t* out = Row(next_.data(), i);
+    for (std::size_t k = 0; k < words_; ++k) {
+      if (!active[k]) {
+        continue;
+      }
+      // Los bits que sobran de la última palabra no son células (en la actual son columnas fantasma)
+      const uint64_t mask = (k + 1 == words_) ? tail_mask_ : ~0ULL;
+      const uint64_t word = CrossRule(center[k], center[static_cast<long>(k) - 1], center[k + 1], up1[k], up2[k], down1[k], down2[k]) & mask;
+      const uint64_t old = center[k] & mask;
+      population += __builtin_popcountll(word) - __builtin_popcountll(old);
+      changed[k] |= (word != old);
+      out[k] = word;
+    }
+  }
+  return population;
+}
+
+/**
+ * @brief Metodo que se encarga de guardar el estado del retículo en un string
+ * Igual que Lattice: una línea por fila, un espacio por célula muerta y una X por célula viva.
+ * @param lattice string al que se añade el retículo
+ * @return std::string el string con el retículo
+ */
+std::string BitLattice::SaveToString(std::string& lattice) {
+  for (int i = 0; i < rows_; ++i) {
+    for (int j = 0; j < columns_; ++j) {
+      lattice += (getState({i, j}) == DEAD) ? " " : "X";
+    }
+    lattice.push_back('\n');
+  }
+  return lattice;
+}
+
+/**
+ * @brief Sobre carga del operador de inserción
+ * Se encarga de imprimir el estado del retículo, igual que el de Lattice
+ * @param os flujo de salida
+ * @param lattice retículo a imprimir
+ * @return std::ostream& flujo de salida
+ */
+std::ostream& operator<<(std::ostream& os, const BitLattice& lattice) {
+  for (int i = 0; i < lattice.getRows(); ++i) {
+    for (int j = 0; j < lattice.getColumns(); ++j) {
+      os << ((lattice.getState({i, j}) == DEAD) ? " " : "X");
+    }
+    os << '\n';
+  }
+  return os;
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+/**
+ * ************ PRÁCTICA 2 *************
+ * @file BitLattice.h
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-22
+ * @brief Creación de la clase Retículo de bits.
+ * Es una alternativa a la clase Lattice pensada para retículos grandes. En lugar de guardar un puntero
+ * a un objeto Cell por cada posición, cada fila se guarda como bits dentro de palabras de 64 bits
+ * (64 células por palabra, 1 bit por célula). La vecindad en cruz doble de Cell::Neighbors se cuenta
+ * para 64 células a la vez con desplazamientos y sumadores hechos con operaciones lógicas, y la regla
+ * 23/3 se aplica también con operaciones lógicas sobre palabras completas.
+ * Admite las fronteras periódica, reflectora y abierta.
+ * El retículo se divide en teselas de 64 x 64 células (64 filas de una palabra) y en cada generación
+ * solo se calculan las teselas que cambiaron en la anterior y sus vecinas: en las zonas muertas o
+ * estables no se hace nada, así que el coste depende de la actividad y no del tamaño del retículo.
+ * Con varios hilos, el retículo se reparte en bandas horizontales de teselas, una por hilo.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef BITLATTICE_H
+#define BITLATTICE_H
+
+#include "Cell.h"
+#include "Lattice.h"
+#include "ThreadPool.h"
+
+/**
+ * @brief Función que aplica la regla 23/3 de la vecindad en cruz doble a 64 células a la vez.
+ * Se construyen las cuatro palabras de la vecindad: cada bit dice si las dos células de ese lado (a
+ * distancia 1 y 2) están vivas. Arriba y abajo es el AND de las palabras de las dos filas; a izquierda
+ * y derecha, el AND de la palabra desplazada uno y dos bits, arrastrando los de la palabra contigua.
+ * Los cuatro bits de cada célula se suman con dos semisumadores y un sumador completo: ones es el bit
+ * de peso 1 y twos el de peso 2. La suma va de 0 a 4 y 4 tiene twos a 0, así que twos vale 1
+ * exactamente con 2 o 3 vecinos, y la regla queda en twos AND (ones OR viva).
+ * @param word palabra de la fila con las 64 células
+ * @param previous palabra anterior de la misma fila (columnas más pequeñas)
+ * @param following palabra siguiente de la misma fila
+ * @param up1 palabra de la fila de arriba
+ * @param up2 palabra de la fila a distancia 2 por arriba
+ * @param down1 palabra de la fila de abajo
+ * @param down2 palabra de la fila a distancia 2 por abajo
+ * @return uint64_t siguiente estado de las 64 células
+ */
+inline uint64_t CrossRule(const uint64_t& word, const uint64_t& previous, const uint64_t& following, const uint64_t& up1,
+                          const uint64_t& up2, const uint64_t& down1, const uint64_t& down2) {
+  const uint64_t left = ((word << 1) | (previous >> 63)) & ((word << 2) | (previous >> 62));
+  const uint64_t right = ((word >> 1) | (following << 63)) & ((word >> 2) | (following << 62));
+  const uint64_t up = up1 & up2;
+  const uint64_t down = down1 & down2;
+  const uint64_t sum_sides = left ^ right, carry_sides = left & right;
+  const uint64_t sum_vertical = up ^ down, carry_vertical = up & down;
+  const uint64_t ones = sum_sides ^ sum_vertical;
+  const uint64_t twos = carry_sides ^ carry_vertical ^ (sum_sides & sum_vertical);
+  return twos & (ones | word);
+}
+
+/**
+ * @brief Función que mezcla los bits de una clave de 64 bits (mezcla final de splitmix64).
+ * La usan las tablas hash de SparseWorld y de HashLife.
+ * @param key clave
+ * @return uint64_t clave mezclada, cada bit depende de todos los de la clave
+ */
+inline uint64_t MixKey(uint64_t key) {
+  key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+  return key ^ (key >> 31);
+}
+
+/**
+ * @brief Estadísticas de las teselas activas
+ * Una tesela está activa en una generación si cambió ella o alguna de sus vecinas en la anterior;
+ * las demás no pueden cambiar y se saltan.
+ */
+struct TileActivity {
+  std::size_t tiles = 0; // teselas que hay
+  std::size_t active = 0; // teselas calculadas en la última generación
+  std::size_t evaluated = 0; // teselas calculadas desde el principio
+  std::size_t skipped = 0; // teselas saltadas desde el principio
+  // fracción de las teselas que se han saltado desde el principio
+  double SkipRatio() const { return evaluated + skipped == 0 ? 0.0 : static_cast<double>(skipped) / (evaluated + skipped); }
+};
+
+/**
+ * @brief Clase Retículo de bits
+ * La célula (i, j) está en el bit j % 64 de la palabra j / 64 de la fila i. Como la vecindad llega a
+ * distancia 2, alrededor del retículo hay dos filas y dos columnas fantasma por cada lado, que se
+ * rellenan según la frontera antes de cada generación: las filas fantasma son filas completas de
+ * palabras, y las columnas -1 y -2 son los dos últimos bits de una palabra de relleno a la izquierda
+ * de cada fila; las columnas N y N + 1 son los bits siguientes a la última célula.
+ * Se usan dos buffers que se intercambian en cada generación. La tesela (r, k) son las palabras k de
+ * las filas 64 * r a 64 * r + 63. Como la vecindad llega a distancia 2, una tesela solo depende de
+ * ella misma, de sus cuatro vecinas y, en los bordes, de las teselas de las que se copian las fantasmas.
+ */
+class BitLattice {
+ public:
+  // Constructor para cuando se le pasa -size, pide el estado de cada célula como Lattice
+  BitLattice(const int& rows, const int& columns, const BorderType& border, const State& openState);
+  // Constructor para cuando se pasa -init
+  BitLattice(const BorderType& border, const State& openState, const std::string& filename);
+  // Getters de la clase
+  int getRows() const { return rows_; }
+  int getColumns() const { return columns_; }
+  const BorderType& getBorder() const { return borderType_; }
+  // método que devuelve el estado de la célula en la posición dada
+  State getState(const Position&) const;
+  // método modificador para poder establecer la configuración inicial
+  void setState(const Position&, const State&);
+  // método que evoluciona el autómata celular
+  void NextGeneration();
+  std::string SaveToString(std::string& lattice);
+  // Funcion para saber cuantas celulas vivas hay, sin recorrer el retículo
+  std::size_t Population() const { return population_; }
+  // Getter de las estadísticas de las teselas activas
+  const TileActivity& getActivity() const { return activity_; }
+  // método que cambia el número de hilos con los que se evoluciona el retículo
+  void setThreads(const std::size_t& threads);
+  // método que evoluciona el autómata celular varias generaciones
+  void Evolve(const long& generations);
+  // método que imprime el estado del retículo
+  friend std::ostream& operator<<(std::ostream&, const BitLattice&);
+
+ private:
+  // Filas y columnas fantasma a cada lado
+  static constexpr int kGhost = 2;
+  // Filas de cada tesela (las columnas son las 64 de una palabra)
+  static constexpr int kTileRows = 64;
+  // método que reserva los buffers según el tamaño
+  void Allocate();
+  // método que devuelve la palabra de la columna 0 de una fila, también de las filas fantasma
+  uint64_t* Row(uint64_t* words, const int& row) const { return words + (row + kGhost) * stride_ + 1; }
+  const uint64_t* Row(const int& row) const { return current_.data() + (row + kGhost) * stride_ + 1; }
+  // método que devuelve la fila o columna de la que se copia una fantasma según la frontera
+  int Source(const int& index, const int& size) const;
+  // método que rellena las filas y columnas fantasma según la frontera
+  void UpdateBorders();
+  // método que marca las teselas que hay que calcular a partir de las que cambiaron
+  void MarkActive();
+  // método que prepara el cálculo de una generación: fantasmas y teselas activas
+  void BeginGeneration();
+  // método que calcula las teselas activas de las filas [begin, end) de la siguiente generación
+  long StepRows(const int& begin, const int& end);
+  std::vector<uint64_t> current_; // generación actual
+  std::vector<uint64_t> next_; // siguiente generación
+  int rows_; // número de filas
+  int columns_; // número de columnas
+  std::size_t words_; // palabras con células de cada fila
+  std::size_t stride_; // palabras de cada fila, con las de relleno
+  uint64_t tail_mask_; // máscara con los bits válidos de la última palabra de cada fila
+  BorderType borderType_; // tipo de frontera
+  State openState_; // estado de las células fantasma si la frontera es abierta
+  std::size_t population_ = 0; // número de células vivas
+  int tile_rows_; // filas de teselas
+  std::vector<uint8_t> changed_; // si cada tesela cambió en la última generación
+  std::vector<uint8_t> active_; // si cada tesela se calcula en la generación actual
+  TileActivity activity_; // estadísticas de las teselas activas
+  std::unique_ptr<ThreadPool> pool_; // hilos persistentes, nullptr si se usa solo el hilo principal
+};
+
+// Sobrecarga del operador de salida
+std::ostream& operator<<(std::ostream&, const BitLattice&);
+
+#endif // BITLATTICE_H
\ No newline at end of file
@@ -61,7 +61,7 @@ int Cell::NextState(const Lattice& lattice) {
   State next_state = state_;
   // Aplicamos la regla 23/3
   if (state_ == ALIVE) {
-    if (alive_neighbors != 2 || alive_neighbors != 3) {
+    if (alive_neighbors != 2 && alive_neighbors != 3) {
       next_state = DEAD;
     }
   } else {
@@ -0,0 +1,508 @@
+/**
+ * ************ PRÁCTICA 2 *************
+ * @file HashLife.cc
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-22
+ * @brief Implementación de los métodos de la clase HashLife.
+ * Encontramos los constructores, la construcción de los nodos canónicos, el cálculo memorizado del
+ * centro de cada nodo, el salto de cualquier número de generaciones, la recogida de los nodos que ya
+ * no se usan y la sobrecarga del operador de salida.
+ */
+
+#include "HashLife.h"
+
+// Bytes aproximados de cada entrada de las tablas hash (clave, valor, puntero al siguiente y cubeta)
+static constexpr std::size_t kEntryBytes = 48;
+
+/**
+ * @brief Construct a new HashLife:: HashLife object
+ * Igual que Lattice, se pide por teclado el estado inicial de cada célula.
+ * @param rows número de filas de la configuración inicial
+ * @param columns número de columnas de la configuración inicial
+ * @param memory presupuesto de memoria de la caché de nodos, en bytes
+ */
+HashLife::HashLife(const int& rows, const int& columns, const std::size_t& memory)
+    : rows_(rows), columns_(columns), memory_(memory) {
+  std::vector<std::vector<State>> cells(rows_, std::vector<State>(columns_, DEAD));
+  for (int i = 0; i < rows_; ++i) {
+    for (int j = 0; j < columns_; ++j) {
+      std::cout << "Ingrese el estado inicial (0 para muerta, 1 para viva) de la celda en la posición [" << i << ", " << j << "]: ";
+      int inputState;
+      std::cin >> inputState;
+      cells[i][j] = static_cast<State>(inputState);
+    }
+  }
+  Build(cells);
+}
+
+/**
+ * @brief Construct a new HashLife:: HashLife object
+ * Se leen el número de filas, el de columnas y después el estado de cada célula (0 o 1), fila a fila,
+ * con el mismo formato que BitLattice.
+ * @param filename nombre del archivo de configuración inicial
+ * @param memory presupuesto de memoria de la caché de nodos, en bytes
+ */
+HashLife::HashLife(const std::string& filename, const std::size_t& memory) : memory_(memory) {
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    throw std::runtime_error("Could not open the file");
+  }
+  if (!(file >> rows_ >> columns_)) {
+    throw std::runtime_error("Error reading the number of rows and columns");
+  }
+  if (rows_ <= 0 || columns_ <= 0) {
+    throw std::runtime_error("The number of rows and columns must be greater than 0");
+  }
+  std::vector<std::vector<State>> cells(rows_, std::vector<State>(columns_, DEAD));
+  for (int i = 0; i < rows_; ++i) {
+    for (int j = 0; j < columns_; ++j) {
+      int cellState;
+      if (!(file >> cellState)) {
+        throw std::runtime_error("Error reading cell state");
+      }
+      cells[i][j] = (cellState == 1) ? ALIVE : DEAD;
+    }
+  }
+  Build(cells);
+}
+
+/**
+ * @brief Método que construye la raíz a partir de la configuración inicial.
+ * La raíz es la más pequeña (de nivel 5 como mínimo) cuya mitad de lado cubre las filas y columnas de
+ * la configuración inicial, que empieza en la célula (0, 0) del centro.
+ * @param cells estado de cada célula de la configuración inicial
+ */
+void HashLife::Build(const std::vector<std::vector<State>>& cells) {
+  int level = 5;
+  while ((1L << (level - 1)) < std::max(rows_, columns_)) {
+    ++level;
+  }
+  root_ = Build(cells, level, -(1L << (level - 1)), -(1L << (level - 1)));
+}
+
+/**
+ * @brief Método que construye el nodo de un cuadrado de la configuración inicial.
+ * Los cuadrados que quedan fuera de la configuración inicial son el nodo vacío de su nivel.
+ * @param cells estado de cada célula de la configuración inicial
+ * @param level nivel del nodo
+ * @param top fila de la esquina superior izquierda del cuadrado
+ * @param left columna de la esquina superior izquierda del cuadrado
+ * @return uint32_t nodo del cuadrado
+ */
+uint32_t HashLife::Build(const std::vector<std::vector<State>>& cells, const int& level, const long& top, const long& left) {
+  const long size = 1L << level;
+  if (top >= rows_ || left >= columns_ || top + size <= 0 || left + size <= 0) {
+    return Empty(level);
+  }
+  if (level == kLeafLevel) {
+    uint64_t bits = 0;
+    for (long i = std::max(top, 0L); i < std::min(top + size, static_cast<long>(rows_)); ++i) {
+      for (long j = std::max(left, 0L); j < std::min(left + size, static_cast<long>(columns_)); ++j) {
+        bits |= static_cast<uint64_t>(cells[i][j]) << (8 * (i - top) + (j - left));
+      }
+    }
+    return Leaf(bits);
+  }
+  const long half = size / 2;
+  const uint32_t nw = Build(cells, level - 1, top, left);
+  const uint32_t ne = Build(cells, level - 1, top, left + half);
+  const uint32_t sw = Build(cells, level - 1, top + half, left);
+  const uint32_t se = Build(cells, level - 1, top + half, left + half);
+  return Join(nw, ne, sw, se);
+}
+
+/**
+ * @brief Método que devuelve la hoja canónica con unas células.
+ * Si ya existe se devuelve la misma; si no, se crea.
+ * @param bits células de la hoja, la (i, j) en el bit 8 * i + j
+ * @return uint32_t hoja
+ */
+uint32_t HashLife::Leaf(const uint64_t& bits) {
+  const auto found = leaves_.find(bits);
+  if (found != leaves_.end()) {
+    return found->second;
+  }
+  const uint32_t node = nodes_.size();
+  nodes_.push_back({{kNone, kNone, kNone, kNone}, bits, static_cast<uint64_t>(__builtin_popcountll(bits)), kNone, kLeafLevel});
+  leaves_.emplace(bits, node);
+  return node;
+}
+
+/**
+ * @brief Método que devuelve el nodo canónico con unos hijos.
+ * Si ya existe se devuelve el mismo; si no, se crea con la población de sus hijos.
+ * @param nw hijo noroeste
+ * @param ne hijo noreste
+ * @param sw hijo suroeste
+ * @param se hijo sureste
+ * @return uint32_t nodo
+ */
+uint32_t HashLife::Join(const uint32_t& nw, const uint32_t& ne, const uint32_t& sw, const uint32_t& se) {
+  const std::array<uint32_t, 4> children{nw, ne, sw, se};
+  const auto found = joins_.find(children);
+  if (found != joins_.end()) {
+    return found->second;
+  }
+  const uint32_t node = nodes_.size();
+  const uint64_t population = nodes_[nw].population + nodes_[ne].population + nodes_[sw].population + nodes_[se].population;
+  nodes_.push_back({children, 0, population, kNone, nodes_[nw].level + 1});
+  joins_.emplace(children, node);
+  return node;
+}
+
+/**
+ * @brief Método que devuelve el nodo vacío de un nivel, creándolo la primera vez.
+ * @param level nivel
+ * @return uint32_t nodo vacío
+ */
+uint32_t HashLife::Empty(const int& level) {
+  if (empty_.size() <= static_cast<std::size_t>(level)) {
+    empty_.resize(level + 1, kNone);
+  }
+  if (empty_[level] == kNone) {
+    const uint32_t child = (level == kLeafLevel) ? kNone : Empty(level - 1);
+    empty_[level] = (level == kLeafLevel) ? Leaf(0) : Join(child, child, child, child);
+  }
+  return empty_[level];
+}
+
+/**
+ * @brief Método que devuelve el cuadrado central de un nodo, sin avanzar ninguna generación.
+ * Está formado por el nieto sureste del hijo noroeste, el suroeste del noreste, etc.
+ * @param node nodo de nivel 4 o más
+ * @return uint32_t centro, un nivel por debajo
+ */
+uint32_t HashLife::Centre(const uint32_t& node) {
+  if (nodes_[node].level == kLeafLevel + 1) {
+    return Base(node, 0);
+  }
+  const std::array<uint32_t, 4> children = nodes_[node].children;
+  return Join(nodes_[children[0]].children[3], nodes_[children[1]].children[2], nodes_[children[2]].children[1],
+              nodes_[children[3]].children[0]);
+}
+
+/**
+ * @brief Método que calcula el centro de un nodo de nivel 4 (16 x 16 células) directamente.
+ * Cada fila del nodo se guarda en los 16 bits bajos de una palabra y se aplica CrossRule como en
+ * BitLattice, con las células de fuera a 0. Los bits que dependen de esas células dejan de ser
+ * correctos, pero en 2 generaciones solo se estropean 4 filas y columnas por cada lado, que son las
+ * que quedan fuera del centro de 8 x 8.
+ * @param node nodo de nivel 4
+ * @param generations generaciones que se avanza, de 0 a 2
+ * @return uint32_t hoja con el centro
+ */
+uint32_t HashLife::Base(const uint32_t& node, const int& generations) {
+  const std::array<uint32_t, 4> children = nodes_[node].children;
+  uint64_t rows[16];
+  for (int r = 0; r < 8; ++r) {
+    rows[r] = ((nodes_[children[0]].bits >> (8 * r)) & 0xFF) | ((nodes_[children[1]].bits >> (8 * r)) & 0xFF) << 8;
+    rows[r + 8] = ((nodes_[children[2]].bits >> (8 * r)) & 0xFF) | ((nodes_[children[3]].bits >> (8 * r)) & 0xFF) << 8;
+  }
+  for (int generation = 0; generation < generations; ++generation) {
+    uint64_t next[16];
+    for (int r = 0; r < 16; ++r) {
+      next[r] = CrossRule(rows[r], 0, 0, r >= 1 ? rows[r - 1] : 0, r >= 2 ? rows[r - 2] : 0, r + 1 < 16 ? rows[r + 1] : 0,
+                          r + 2 < 16 ? rows[r + 2] : 0) & 0xFFFF;
+    }
+    std::copy(next, next + 16, rows);
+  }
+  uint64_t bits = 0;
+  for (int r = 0; r < 8; ++r) {
+    bits |= ((rows[r + 4] >> 4) & 0xFF) << (8 * r);
+  }
+  return Leaf(bits);
+}
+
+/**
+ * @brief Método que devuelve el centro de un nodo de nivel k avanzado 2^j generaciones (j <= k - 3).
+ * Se forman los nueve cuadrados de nivel k - 1 que se solapan (los cuatro hijos, los cuatro de entre
+ * dos hijos y el central) y se toma su centro: avanzado 2^(k-4) generaciones si se avanza el máximo,
+ * o sin avanzar si no. Los nueve centros forman cuatro cuadrados de nivel k - 1 cuyos centros,
+ * avanzados lo que falta, son las cuatro partes del resultado.
+ * El resultado del máximo se guarda en el nodo; los de saltos más cortos, en steps_.
+ * @param node nodo de nivel 4 o más
+ * @param j logaritmo en base 2 de las generaciones
+ * @return uint32_t centro avanzado, un nivel por debajo
+ */
+uint32_t HashLife::Advance(const uint32_t& node, const int& j) {
+  const int level = nodes_[node].level;
+  if (nodes_[node].population == 0) {
+    return Empty(level - 1);
+  }
+  const bool full = (j == level - 3);
+  const uint64_t key = static_cast<uint64_t>(node) << 8 | j;
+  if (full && nodes_[node].result != kNone) {
+    return nodes_[node].result;
+  }
+  if (!full) {
+    const auto found = steps_.find(key);
+    if (found != steps_.end()) {
+      return found->second;
+    }
+  }
+  uint32_t result;
+  if (level == kLeafLevel + 1) {
+    result = Base(node, 1 << j);
+  } else {
+    const std::array<uint32_t, 4> children = nodes_[node].children;
+    const std::array<uint32_t, 4> a = nodes_[children[0]].children, b = nodes_[children[1]].children;
+    const std::array<uint32_t, 4> c = nodes_[children[2]].children, d = nodes_[children[3]].children;
+    const uint32_t squares[9] = {children[0],           Join(a[1], b[0], a[3], b[2]), children[1],
+                                 Join(a[2], a[3], c[0], c[1]), Join(a[3], b[2], c[1], d[0]), Join(b[2], b[3], d[0], d[1]),
+                                 children[2],           Join(c[1], d[0], c[3], d[2]), children[3]};
+    uint32_t centres[9];
+    for (int i = 0; i < 9; ++i) {
+      centres[i] = full ? Advance(squares[i], level - 4) : Centre(squares[i]);
+    }
+    const int rest = full ? level - 4 : j;
+    const uint32_t nw = Advance(Join(centres[0], centres[1], centres[3], centres[4]), rest);
+    const uint32_t ne = Advance(Join(centres[1], centres[2], centres[4], centres[5]), rest);
+    const uint32_t sw = Advance(Join(centres[3], centres[4], centres[6], centres[7]), rest);
+    const uint32_t se = Advance(Join(centres[4], centres[5], centres[7], centres[8]), rest);
+    result = Join(nw, ne, sw, se);
+  }
+  if (full) {
+    nodes_[node].result = result;
+  } else {
+    steps_.emplace(key, result);
+  }
+  return result;
+}
+
+/**
+ * @brief Método que dobla el lado de la raíz.
+ * Cada hijo de la raíz pasa a ser el nieto más cercano al centro de un hijo nuevo rodeado de nodos
+ * vacíos, así que las células siguen en las mismas coordenadas.
+ */
+void HashLife::Expand() {
+  const std::array<uint32_t, 4> children = nodes_[root_].children;
+  const uint32_t empty = Empty(nodes_[root_].level - 1);
+  const uint32_t nw = Join(empty, empty, empty, children[0]);
+  const uint32_t ne = Join(empty, empty, children[1], empty);
+  const uint32_t sw = Join(empty, children[2], empty, empty);
+  const uint32_t se = Join(children[3], empty, empty, empty);
+  root_ = Join(nw, ne, sw, se);
+}
+
+/**
+ * @brief Método que comprueba si todas las células vivas están en el cuadrado central de la raíz.
+ * @return true si la población del centro es la de la raíz
+ */
+bool HashLife::InCentre() const {
+  const std::array<uint32_t, 4>& children = nodes_[root_].children;
+  return nodes_[nodes_[children[0]].children[3]].population + nodes_[nodes_[children[1]].children[2]].population +
+             nodes_[nodes_[children[2]].children[1]].population + nodes_[nodes_[children[3]].children[0]].population ==
+         nodes_[root_].population;
+}
+
+/**
+ * @brief Método que avanza la raíz 2^j generaciones.
+ * Antes se comprueba el presupuesto de memoria. La raíz se amplía hasta que es de nivel j + 3 como
+ * mínimo y todas las células vivas están en su centro, y una vez más: en 2^j generaciones la vida
+ * avanza como mucho 2^(j+1) células por lado, así que sigue dentro del centro que se devuelve.
+ * @param j logaritmo en base 2 de las generaciones
+ */
+void HashLife::AdvanceRoot(const int& j) {
+  if (getBytes() > memory_) {
+    Collect();
+  }
+  while (nodes_[root_].level < j + 3 || !InCentre()) {
+    Expand();
+  }
+  Expand();
+  root_ = Advance(root_, j);
+  generation_ += 1L << j;
+}
+
+/**
+ * @brief Método que avanza el autómata celular cualquier número de generaciones.
+ * Se descompone en potencias de 2, de la mayor a la menor. Si se pasaría de kMaxGeneration, no se avanza.
+ * @param generations número de generaciones
+ */
+void HashLife::Jump(long generations) {
+  if (generations > kMaxGeneration - generation_) {
+    std::cerr << "Cannot advance beyond generation " << kMaxGeneration << "." << std::endl;
+    return;
+  }
+  for (int j = 62; j >= 0; --j) {
+    if ((generations >> j) & 1L) {
+      AdvanceRoot(j);
+    }
+  }
+}
+
+/**
+ * @brief Método que devuelve la memoria aproximada de la caché de nodos.
+ * @return std::size_t bytes de los nodos y de las tablas hash
+ */
+std::size_t HashLife::getBytes() const {
+  return nodes_.capacity() * sizeof(Node) + (leaves_.size() + joins_.size() + steps_.size()) * kEntryBytes;
+}
+
+/**
+ * @brief Método que descarta los nodos que no forman parte del plano actual.
+ * Se marcan los nodos a los que se llega desde la raíz y los nodos vacíos, y se copian en orden a un
+ * vector nuevo: los hijos siempre se crean antes que sus padres, así que ya tienen su posición nueva
+ * cuando se copia el padre. Los resultados guardados que apuntan a nodos descartados se olvidan, y los
+ * de los saltos más cortos se borran todos.
+ */
+void HashLife::Collect() {
+  std::vector<uint8_t> live(nodes_.size(), 0);
+  std::vector<uint32_t> pending(empty_.begin(), empty_.end());
+  pending.push_back(root_);
+  while (!pending.empty()) {
+    const uint32_t node = pending.back();
+    pending.pop_back();
+    if (node == kNone || live[node]) {
+      continue;
+    }
+    live[node] = 1;
+    if (nodes_[node].level > kLeafLevel) {
+      pending.insert(pending.end(), nodes_[node].children.begin(), nodes_[node].children.end());
+    }
+  }
+  std::vector<uint32_t> index(nodes_.size(), kNone);
+  std::vector<Node> nodes;
+  leaves_.clear();
+  joins_.clear();
+  steps_.clear();
+  for (uint32_t node = 0; node < nodes_.size(); ++node) {
+    if (!live[node]) {
+      continue;
+    }
+    Node copy = nodes_[node];
+    index[node] = nodes.size();
+    if (copy.level == kLeafLevel) {
+      leaves_.emplace(copy.bits, index[node]);
+    } else {
+      for (uint32_t& child : copy.children) {
+        child = index[child];
+      }
+      joins_.emplace(copy.children, index[node]);
+    }
+    nodes.push_back(copy);
+  }
+  for (Node& node : nodes) {
+    node.result = (node.result == kNone) ? kNone : index[node.result];
+  }
+  nodes_.swap(nodes);
+  nodes_.shrink_to_fit();
+  root_ = index[root_];
+  for (uint32_t& empty : empty_) {
+    empty = (empty == kNone) ? kNone : index[empty];
+  }
+}
+
+/**
+ * @brief Método que devuelve el estado de una célula.
+ * Se baja desde la raíz eligiendo en cada nivel el hijo que contiene la célula.
+ * @param position fila y columna de la célula, pueden ser negativas
+ * @return State estado de la célula
+ */
+State HashLife::getState(const Position& position) const {
+  const Node* node = &nodes_[root_];
+  const long half = 1L << (node->level - 1);
+  long row = position.first + half, column = position.second + half;
+  if (row < 0 || column < 0 || row >= 2 * half || column >= 2 * half) {
+    return DEAD;
+  }
+  while (node->level > kLeafLevel) {
+    const long size = 1L << (node->level - 1);
+    const int quadrant = (row >= size ? 2 : 0) + (column >= size ? 1 : 0);
+    row %= size;
+    column %= size;
+    node = &nodes_[node->children[quadrant]];
+  }
+  return (node->bits >> (8 * row + column)) & 1ULL;
+}
+
+/**
+ * @brief Método que amplía un rectángulo para que quepan las células vivas de un nodo.
+ * Los nodos vacíos no se recorren.
+ * @param node nodo
+ * @param top fila de la esquina superior izquierda del nodo
+ * @param left columna de la esquina superior izquierda del nodo
+ * @param min_row primera fila del rectángulo
+ * @param min_column primera columna del rectángulo
+ * @param max_row última fila del rectángulo
+ * @param max_column última columna del rectángulo
+ */
+void HashLife::Extents(const uint32_t& node, const long& top, const long& left, long& min_row, long& min_column, long& max_row,
+                       long& max_column) const {
+  if (nodes_[node].population == 0) {
+    return;
+  }
+  if (nodes_[node].level == kLeafLevel) {
+    for (int r = 0; r < 8; ++r) {
+      const uint64_t row = (nodes_[node].bits >> (8 * r)) & 0xFF;
+      if (row != 0) {
+        min_row = std::min(min_row, top + r);
+        max_row = std::max(max_row, top + r);
+        min_column = std::min(min_column, left + __builtin_ctzll(row));
+        max_column = std::max(max_column, left + 63 - __builtin_clzll(row));
+      }
+    }
+    return;
+  }
+  const long half = 1L << (nodes_[node].level - 1);
+  const std::array<uint32_t, 4>& children = nodes_[node].children;
+  Extents(children[0], top, left, min_row, min_column, max_row, max_column);
+  Extents(children[1], top, left + half, min_row, min_column, max_row, max_column);
+  Extents(children[2], top + half, left, min_row, min_column, max_row, max_column);
+  Extents(children[3], top + half, left + half, min_row, min_column, max_row, max_column);
+}
+
+/**
+ * @brief Método que calcula el rectángulo que se imprime.
+ * Es el de la configuración inicial ampliado para que quepan todas las células vivas.
+ * @param top primera fila
+ * @param left primera columna
+ * @param bottom última fila
+ * @param right última columna
+ */
+void HashLife::Bounds(long& top, long& left, long& bottom, long& right) const {
+  top = 0;
+  left = 0;
+  bottom = rows_ - 1;
+  right = columns_ - 1;
+  const long half = 1L << (nodes_[root_].level - 1);
+  Extents(root_, -half, -half, top, left, bottom, right);
+}
+
+/**
+ * @brief Metodo que se encarga de guardar el estado del plano en un string
+ * Igual que Lattice: una línea por fila, un espacio por célula muerta y una X por célula viva.
+ * @param lattice string al que se añade el plano
+ * @return std::string el string con el plano
+ */
+std::string HashLife::SaveToString(std::string& lattice) {
+  long top, left, bottom, right;
+  Bounds(top, left, bottom, right);
+  for (long i = top; i <= bottom; ++i) {
+    for (long j = left; j <= right; ++j) {
+      lattice += (getState({static_cast<int>(i), static_cast<int>(j)}) == DEAD) ? " " : "X";
+    }
+    lattice.push_back('\n');
+  }
+  return lattice;
+}
+
+/**
+ * @brief Sobre carga del operador de inserción
+ * Se imprime el rectángulo con la configuración inicial y todas las células vivas, como SparseWorld
+ * @param os flujo de salida
+ * @param hashlife plano a imprimir
+ * @return std::ostream& flujo de salida
+ */
+std::ostream& operator<<(std::ostream& os, const HashLife& hashlife) {
+  long top, left, bottom, right;
+  hashlife.Bounds(top, left, bottom, right);
+  for (long i = top; i <= bottom; ++i) {
+    for (long j = left; j <= right; ++j) {
+      os << ((hashlife.getState({static_cast<int>(i), static_cast<int>(j)}) == DEAD) ? " " : "X");
+    }
+    os << '\n';
+  }
+  return os;
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+/**
+ * ************ PRÁCTICA 2 *************
+ * @file HashLife.h
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-22
+ * @brief Creación de la clase HashLife (evolución del plano sin frontera con un árbol cuaternario).
+ * Para evolucionar muchas generaciones (millones o más) no sirve calcular una a una. Aquí el plano
+ * infinito se guarda como un árbol cuaternario en el que cada nodo es un cuadrado de 2^k x 2^k
+ * células formado por cuatro nodos de 2^(k-1). Los nodos son canónicos: dos cuadrados iguales son el
+ * mismo nodo, estén donde estén, así que las zonas repetidas o vacías solo se guardan una vez.
+ * Cada nodo recuerda su resultado: el cuadrado central de 2^(k-1) células avanzado 2^(k-3)
+ * generaciones. Con la vecindad de radio 1 serían 2^(k-2), pero la vecindad en cruz doble llega a
+ * distancia 2 y el cono de luz se estrecha dos células por lado y generación. Un resultado calculado
+ * una vez sirve para todas las veces que aparece ese cuadrado, en cualquier sitio y generación.
+ * Si la caché de nodos pasa del presupuesto de memoria, se descartan los que no forman parte del plano actual.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifndef HASHLIFE_H
+#define HASHLIFE_H
+
+#include "BitLattice.h"
+#include "Cell.h"
+
+/**
+ * @brief Clase HashLife
+ * Los nodos se guardan en un vector y se referencian por su posición. Las hojas (nivel 3) son
+ * cuadrados de 8 x 8 células en una palabra: la célula (i, j) de la hoja es el bit 8 * i + j. La raíz
+ * de nivel k cubre las filas y columnas -2^(k-1) a 2^(k-1) - 1, y la configuración inicial ocupa las
+ * filas 0 a M - 1 y las columnas 0 a N - 1.
+ */
+class HashLife {
+ public:
+  // Generación máxima. La vida avanza como mucho 2 células por generación, así que hasta aquí la raíz
+  // no pasa del nivel 60 y las coordenadas y el contador de generaciones caben en un long
+  static constexpr long kMaxGeneration = 1L << 48;
+  // Constructor para cuando se le pasa -size, pide el estado de cada célula como Lattice
+  HashLife(const int& rows, const int& columns, const std::size_t& memory);
+  // Constructor para cuando se pasa -init
+  HashLife(const std::string& filename, const std::size_t& memory);
+  // Getters de la clase
+  long getGeneration() const { return generation_; }
+  long getStep() const { return step_; }
+  std::size_t getNodes() const { return nodes_.size(); }
+  std::size_t getBytes() const;
+  // setter de las generaciones que avanza NextGeneration
+  void setStep(const long& step) { step_ = step; }
+  // método que devuelve el estado de cualquier célula del plano
+  State getState(const Position&) const;
+  // método que avanza el autómata celular las generaciones del paso
+  void NextGeneration() { Jump(step_); }
+  // método que avanza el autómata celular cualquier número de generaciones
+  void Jump(long generations);
+  std::string SaveToString(std::string& lattice);
+  // Funcion para saber cuantas celulas vivas hay, con la población guardada en la raíz
+  std::size_t Population() const { return nodes_[root_].population; }
+  // método que imprime el rectángulo con la configuración inicial y todas las células vivas
+  friend std::ostream& operator<<(std::ostream&, const HashLife&);
+
+ private:
+  // Nivel de las hojas (8 x 8 células)
+  static constexpr int kLeafLevel = 3;
+  // Posición que indica que un nodo aún no tiene resultado
+  static constexpr uint32_t kNone = UINT32_MAX;
+  /**
+   * @brief Nodo del árbol
+   */
+  struct Node {
+    std::array<uint32_t, 4> children; // hijos noroeste, noreste, suroeste y sureste (sin usar en las hojas)
+    uint64_t bits; // células de una hoja (sin usar en los demás nodos)
+    uint64_t population; // número de células vivas del cuadrado
+    uint32_t result; // centro avanzado 2^(k-3) generaciones, o kNone si no se ha calculado
+    int level; // nivel k, el cuadrado tiene 2^k células de lado
+  };
+  /**
+   * @brief Función hash de los cuatro hijos de un nodo (con MixKey)
+   */
+  struct ChildrenHash {
+    std::size_t operator()(const std::array<uint32_t, 4>& children) const {
+      return MixKey((static_cast<uint64_t>(children[0]) << 32 | children[1]) * 0x9e3779b97f4a7c15ULL ^
+                    (static_cast<uint64_t>(children[2]) << 32 | children[3]));
+    }
+  };
+  // método que construye la raíz a partir de la configuración inicial
+  void Build(const std::vector<std::vector<State>>& cells);
+  // método que construye el nodo de un cuadrado de la configuración inicial
+  uint32_t Build(const std::vector<std::vector<State>>& cells, const int& level, const long& top, const long& left);
+  // método que devuelve la hoja canónica con esas células
+  uint32_t Leaf(const uint64_t& bits);
+  // método que devuelve el nodo canónico con esos hijos
+  uint32_t Join(const uint32_t& nw, const uint32_t& ne, const uint32_t& sw, const uint32_t& se);
+  // método que devuelve el nodo vacío de un nivel
+  uint32_t Empty(const int& level);
+  // método que devuelve el cuadrado central de un nodo, sin avanzar
+  uint32_t Centre(const uint32_t& node);
+  // método que calcula el centro de un nodo de nivel 4 avanzado 0, 1 o 2 generaciones
+  uint32_t Base(const uint32_t& node, const int& generations);
+  // método que devuelve el centro de un nodo avanzado 2^j generaciones
+  uint32_t Advance(const uint32_t& node, const int& j);
+  // método que avanza la raíz 2^j generaciones
+  void AdvanceRoot(const int& j);
+  // método que dobla el lado de la raíz dejando el plano en el centro
+  void Expand();
+  // método que comprueba si todas las células vivas están en el centro de la raíz
+  bool InCentre() const;
+  // método que descarta los nodos que no forman parte del plano actual
+  void Collect();
+  // método que calcula el rectángulo con las células vivas de un nodo
+  void Extents(const uint32_t& node, const long& top, const long& left, long& min_row, long& min_column, long& max_row,
+               long& max_column) const;
+  // método que calcula el rectángulo que hay que imprimir
+  void Bounds(long& top, long& left, long& bottom, long& right) const;
+  std::vector<Node> nodes_; // nodos del árbol
+  std::unordered_map<uint64_t, uint32_t> leaves_; // hojas canónicas por sus células
+  std::unordered_map<std::array<uint32_t, 4>, uint32_t, ChildrenHash> joins_; // nodos canónicos por sus hijos
+  std::unordered_map<uint64_t, uint32_t> steps_; // centros avanzados menos de 2^(k-3) generaciones, por nodo y j
+  std::vector<uint32_t> empty_; // nodo vacío de cada nivel
+  uint32_t root_ = 0; // raíz del árbol
+  int rows_; // filas de la configuración inicial
+  int columns_; // columnas de la configuración inicial
+  long generation_ = 0; // generación actual
+  long step_ = 1; // generaciones que avanza NextGeneration
+  std::size_t memory_; // presupuesto de memoria de la caché de nodos, en bytes
+};
+
+// Sobrecarga del operador de salida
+std::ostream& operator<<(std::ostream&, const HashLife&);
+
+#endif // HASHLIFE_H
\ No newline at end of file
@@ -39,18 +39,6 @@ Lattice::Lattice(const BorderType& border, char* argv[]) {
     }
     rows_ += 2;
     columns_ += 2;
-  } else if (border == NOFRONTER) {
-    cells_.resize(std::atoi(argv[2]), std::vector<Cell*>(std::atoi(argv[3])));
-    for (int i = 0; i < std::atoi(argv[2]); ++i) {
-      for (int j = 0; j < std::atoi(argv[3]); ++j) {
-        cells_[i][j] = new Cell({i, j}, DEAD);
-      }
-    }
-    for (int i = 0; i < std::atoi(argv[2]); ++i) {
-      for (int j = 0; j < std::atoi(argv[3]); ++j) {
-        requestUserInput(i, j);
-      }
-    }
   }
   // Aplicar las fronteras según lo indicado por el usuario
   applyBorders(border, argv);
@@ -77,7 +65,7 @@ void Lattice::requestUserInput(int i, int j) {
  * Si es open y 0 se establecen las células en los bordes en estado de muerte (DEAD).
  * Si es periodic, se ajustan los estados de la forma correspondiente.
  * Si es reflective, se ajustan los estados de la forma correspondiente.
- * Si es nofronter, se ajustan los estados de la forma correspondiente.
+ * Sin frontera ('noborder') no se usa Lattice sino SparseWorld, que crece por teselas.
  * @param border tipo de frontera
  * @param argv argumentos de la linea de comandos
  */
@@ -132,119 +120,6 @@ void Lattice::applyBorders(const BorderType& border, char* argv[]) {
       cells_[rows_ - 1][i] = cells_[rows_ - 3][i];
       cells_[rows_ - 2][i] = cells_[rows_ - 4][i];
     }
-    // Si no hay frontera se ajustan los estados de las células en los bordes.
-  } else if (border == NOFRONTER) {
-    // Crear una nueva matriz con el tamaño expandido
-    for (int i = 0; i < std::atoi(argv[2]); ++i) {
-      std::cout << "it i: " << i << std::endl;
-      for (int j = 0; j < std::atoi(argv[3]); ++j) {
-        if (j == 5) exit(EXIT_FAILURE);
-        std::cout << "it j: " << j << std::endl;
-        if (i == 0 && j == 0 && cells_[i][j]->getState() == ALIVE) {
-          std::vector<Cell*> temp(std::atoi(argv[3]) + 1);
-          for (int k = 0; k < std::atoi(argv[3]) + 1; ++k) {
-            temp[k] = new Cell({i, j}, DEAD);
-          }
-          cells_.insert(cells_.begin(), temp);
-          for (long unsigned k = 1; k < cells_.size(); ++k) {
-            cells_[k].insert(cells_[k].begin(), new Cell({i, j}, DEAD));
-          }
-          for (long unsigned k = 0; k < cells_.size(); ++k) {
-            for (long unsigned l = 0; l < cells_[k].size(); ++l) {
-              cells_[k][l]->setPosition({k, l});
-            } 
-          }
-          ++rows_;
-          ++columns_;
-        } else if (i == 0 && j == std::atoi(argv[3]) - 1 && cells_[i][j]->getState() == ALIVE) {
-          std::vector<Cell*> temp(std::atoi(argv[3]) + 1);
-          for (int k = 0; k < std::atoi(argv[3]) + 1; ++k) {
-            temp[k] = new Cell({i, j}, DEAD);
-          }
-          cells_.insert(cells_.begin(), temp);
-          for (long unsigned k = 1; k < cells_.size(); ++k) {
-            cells_[k].push_back(new Cell({i, j}, DEAD));
-          }
-          for (long unsigned k = 0; k < cells_.size(); ++k) {
-            for (long unsigned l = 0; l < cells_[k].size(); ++l) {
-              cells_[k][l]->setPosition({k, l});
-            } 
-          }
-          ++rows_;
-          ++columns_;
-        } else if (i == std::atoi(argv[2]) - 1 && j == 0 && cells_[i][j]->getState() == ALIVE) {
-          std::vector<Cell*> temp(std::atoi(argv[3]) + 1);
-          for (int k = 0; k < std::atoi(argv[3]) + 1; ++k) {
-            temp[k] = new Cell({i, j}, DEAD);
-          }
-          cells_.push_back(temp);
-          for (long unsigned k = 1; k < cells_.size(); ++k) {
-            cells_[k].insert(cells_[k].begin(), new Cell({i, j}, DEAD));
-          }
-          for (long unsigned k = 0; k < cells_.size(); ++k) {
-            for (long unsigned l = 0; l < cells_[k].size(); ++l) {
-              cells_[k][l]->setPosition({k, l});
-            } 
-          }
-          ++columns_;
-          ++rows_;
-        } else if (i == std::atoi(argv[2]) - 1 && j == std::atoi(argv[3]) - 1 && cells_[i][j]->getState() == ALIVE) {
-          std::vector<Cell*> temp(std::atoi(argv[3]) + 1);
-          for (int k = 0; k < std::atoi(argv[3]) + 1; ++k) {
-            temp[k] = new Cell({i, j}, DEAD);
-          }
-          cells_.push_back(temp);
-          for (long unsigned k = 1; k < cells_.size(); ++k) {
-            cells_[k].push_back(new Cell({i, j}, DEAD));
-          }
-          for(long unsigned k = 0; k < cells_.size(); ++k) {
-            for (long unsigned l = 0; l < cells_[k].size(); ++l) {
-              cells_[k][l]->setPosition({k, l});
-            } 
-          }
-          ++columns_;
-          ++rows_;
-        } else {
-          if (i == 0) {
-            std::vector<Cell*> temp(std::atoi(argv[3]));
-            for (int k = 0; k < std::atoi(argv[3]); ++k) {
-              temp[k] = new Cell({i, j}, DEAD);
-            }
-            cells_.insert(cells_.begin(), temp);
-            for (long unsigned k = 0; k < cells_.size(); ++k) {
-              cells_[k][j]->setPosition({k, j});
-            }
-            ++rows_;
-          } else if (i == std::atoi(argv[2]) - 1) {
-            std::vector<Cell*> temp(std::atoi(argv[3]));
-            for (int k = 0; k < std::atoi(argv[3]); ++k) {
-              temp[k] = new Cell({i, j}, DEAD);
-            }
-            cells_.push_back(temp);
-            for (long unsigned k = 0; k < cells_.size(); ++k) {
-              cells_[k][j]->setPosition({k, j});
-            }
-            ++rows_;
-          } else if (j == 0) {
-            for (long unsigned k = 0; k < cells_.size(); ++k) {
-              cells_[k].insert(cells_[k].begin(), new Cell({i, j}, DEAD));
-            }
-            for (long unsigned k = 0; k < cells_.size(); ++k) {
-              cells_[k][j]->setPosition({k, j});
-            }
-            ++columns_;
-          } else if (j == std::atoi(argv[3]) - 1) {
-            for (long unsigned k = 0; k < cells_.size(); ++k) {
-              cells_[k].push_back(new Cell({i, j}, DEAD));
-            }
-            for (long unsigned k = 0; k < cells_.size(); ++k) {
-              cells_[k][j]->setPosition({k, j});
-            }
-            ++columns_;
-          }
-        }
-      }
-    }
   }
 }
 
@@ -311,13 +186,6 @@ Lattice::~Lattice() {
         cells_[i][j] = nullptr;
       }
     }
-  } else if (borderType_ == NOFRONTER) {
-    for (int i = 0; i < rows_; ++i) {
-      for (int j = 0; j < columns_; ++j) {
-        delete cells_[i][j];
-        cells_[i][j] = nullptr;
-      }
-    }
   }
 }
 
@@ -376,20 +244,6 @@ void Lattice::NextGeneration() {
         cells_[i][j]->UpdateState();
       }
     }
-  } else if (borderType_ == NOFRONTER) {
-    std::cout << rows_ << " " << columns_ << std::endl;
-    for (int i = 0; i < rows_; ++i) {
-      for (int j = 0; j < columns_; ++j) {
-        cells_[i][j]->NextState(*this);
-      }
-    }
-    // Recorremos el retículo y actualizamos el estado de cada célula.
-    for (int i = 1; i < rows_- 1; ++i) {
-      for (int j = 1; j < columns_ - 1; ++j) {
-        cells_[i][j]->UpdateState();
-      }
-    }
-    applyBorders(borderType_, nullptr);
   }
 }
 
@@ -447,20 +301,11 @@ Cell& Lattice::operator[](const Position& position) {
  */
 std::ostream& operator<<(std::ostream& os, const Lattice& lattice) {
  // Recorremos todo el retículo e imprimimos el estado de cada célula
-  if (lattice.getBorder() == NOFRONTER) {
-    for (int i = 0; i < lattice.getRows(); ++i) {
-      for (int j = 0; j < lattice.getColumns(); ++j) {
-        os << lattice.getCell({i, j});
-      }
-      os << std::endl;
-    }
-  } else {
-    for (int i = 1; i < lattice.getRows() - 1; ++i) {
-      for (int j = 1; j < lattice.getColumns() - 1; ++j) {
-        os << lattice.getCell({i, j});
-      }
-      os << std::endl;
+  for (int i = 1; i < lattice.getRows() - 1; ++i) {
+    for (int j = 1; j < lattice.getColumns() - 1; ++j) {
+      os << lattice.getCell({i, j});
     }
+    os << std::endl;
   }
   return os;
 }
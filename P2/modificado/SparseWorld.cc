@@ -0,0 +1,286 @@
+/**
+ * ************ PRÁCTICA 2 *************
+ * @file SparseWorld.cc
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-22
+ * @brief Implementación de los métodos de la clase SparseWorld.
+ * Encontramos los constructores, el acceso a las células, la creación de las teselas vecinas, la
+ * selección de las teselas activas, el método que evoluciona el autómata celular tesela a tesela y la
+ * sobrecarga del operador de salida.
+ */
+
+#include "SparseWorld.h"
+
+/**
+ * @brief Construct a new SparseWorld:: SparseWorld object
+ * Igual que Lattice, se pide por teclado el estado inicial de cada célula.
+ * @param rows número de filas de la configuración inicial
+ * @param columns número de columnas de la configuración inicial
+ */
+SparseWorld::SparseWorld(const int& rows, const int& columns) : rows_(rows), columns_(columns) {
+  for (int i = 0; i < rows_; ++i) {
+    for (int j = 0; j < columns_; ++j) {
+      std::cout << "Ingrese el estado inicial (0 para muerta, 1 para viva) de la celda en la posición [" << i << ", " << j << "]: ";
+      int inputState;
+      std::cin >> inputState;
+      setState({i, j}, static_cast<State>(inputState));
+    }
+  }
+}
+
+/**
+ * @brief Construct a new SparseWorld:: SparseWorld object
+ * Se leen el número de filas, el de columnas y después el estado de cada célula (0 o 1), fila a fila,
+ * con el mismo formato que BitLattice.
+ * @param filename nombre del archivo de configuración inicial
+ */
+SparseWorld::SparseWorld(const std::string& filename) {
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    throw std::runtime_error("Could not open the file");
+  }
+  if (!(file >> rows_ >> columns_)) {
+    throw std::runtime_error("Error reading the number of rows and columns");
+  }
+  if (rows_ <= 0 || columns_ <= 0) {
+    throw std::runtime_error("The number of rows and columns must be greater than 0");
+  }
+  for (int i = 0; i < rows_; ++i) {
+    for (int j = 0; j < columns_; ++j) {
+      int cellState;
+      if (!(file >> cellState)) {
+        throw std::runtime_error("Error reading cell state");
+      }
+      if (cellState == 1) {
+        setState({i, j}, ALIVE);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Método que devuelve una tesela.
+ * Las teselas que no existen están vacías, así que se devuelve una tesela vacía compartida.
+ * @param row fila de la tesela
+ * @param column columna de la tesela
+ * @return const Tile& tesela
+ */
+const SparseWorld::Tile& SparseWorld::Find(const int& row, const int& column) const {
+  static const Tile empty{};
+  const auto found = tiles_.find(Key(row, column));
+  return found == tiles_.end() ? empty : found->second;
+}
+
+/**
+ * @brief Método que devuelve el estado de una célula.
+ * @param position fila y columna de la célula, pueden ser negativas
+ * @return State estado de la célula
+ */
+State SparseWorld::getState(const Position& position) const {
+  const int row = TileOf(position.first), column = TileOf(position.second);
+  const Tile& tile = Find(row, column);
+  return (tile[position.first - row * kTileSize] >> (position.second - column * kTileSize)) & 1ULL;
+}
+
+/**
+ * @brief Setter que establece el estado de una célula, creando su tesela si no existe.
+ * La tesela cuenta como cambiada, así que se calcula en la siguiente generación.
+ * @param position fila y columna de la célula, pueden ser negativas
+ * @param state estado nuevo de la célula
+ */
+void SparseWorld::setState(const Position& position, const State& state) {
+  const int row = TileOf(position.first), column = TileOf(position.second);
+  uint64_t& word = tiles_[Key(row, column)][position.first - row * kTileSize];
+  const uint64_t bit = 1ULL << (position.second - column * kTileSize);
+  population_ += static_cast<std::size_t>(state) - ((word & bit) != 0);
+  word = state ? (word | bit) : (word & ~bit);
+  changed_.insert(Key(row, column));
+}
+
+/**
+ * @brief Método que crea las teselas vecinas a las que puede llegar la vida en la siguiente generación.
+ * La vecindad llega a distancia 2 y es en cruz, así que una célula de fuera de las teselas solo puede
+ * nacer si hay células vivas en las dos primeras o dos últimas filas o columnas de la tesela de al
+ * lado. Solo entonces se crea la tesela vecina por ese lado (vacía). Las diagonales nunca hacen falta.
+ * Basta con mirar las teselas que cambiaron: si una no cambió, su vecina tampoco puede cambiar por ella.
+ */
+void SparseWorld::Expand() {
+  std::vector<uint64_t> missing;
+  for (const uint64_t& key : changed_) {
+    const auto found = tiles_.find(key);
+    if (found == tiles_.end()) {
+      continue;
+    }
+    const int row = static_cast<int32_t>(key >> 32), column = static_cast<int32_t>(key);
+    const Tile& tile = found->second;
+    uint64_t any = 0;
+    for (const uint64_t& word : tile) {
+      any |= word;
+    }
+    const std::pair<bool, uint64_t> sides[] = {
+        {(tile[0] | tile[1]) != 0, Key(row - 1, column)},
+        {(tile[kTileSize - 2] | tile[kTileSize - 1]) != 0, Key(row + 1, column)},
+        {(any & 0x3ULL) != 0, Key(row, column - 1)},
+        {(any & (0x3ULL << 62)) != 0, Key(row, column + 1)}};
+    for (const auto& side : sides) {
+      if (side.first && tiles_.find(side.second) == tiles_.end()) {
+        missing.push_back(side.second);
+      }
+    }
+  }
+  for (const uint64_t& key : missing) {
+    tiles_.emplace(key, Tile{});
+  }
+}
+
+/**
+ * @brief Método que devuelve las teselas que hay que calcular en esta generación.
+ * Son las que existen entre las que cambiaron en la anterior y sus cuatro vecinas; las demás tienen
+ * las mismas células y las mismas vecinas que en la generación anterior, así que no pueden cambiar.
+ * @return std::unordered_set<uint64_t, KeyHash> claves de las teselas activas
+ */
+std::unordered_set<uint64_t, SparseWorld::KeyHash> SparseWorld::Active() const {
+  std::unordered_set<uint64_t, KeyHash> active;
+  for (const uint64_t& key : changed_) {
+    const int row = static_cast<int32_t>(key >> 32), column = static_cast<int32_t>(key);
+    const uint64_t keys[] = {key, Key(row - 1, column), Key(row + 1, column), Key(row, column - 1), Key(row, column + 1)};
+    for (const uint64_t& neighbor : keys) {
+      if (tiles_.count(neighbor) != 0) {
+        active.insert(neighbor);
+      }
+    }
+  }
+  return active;
+}
+
+/**
+ * @brief Función que evoluciona el autómata celular una generación.
+ * Primero se crean las teselas vecinas necesarias y se calcula la siguiente generación de las teselas
+ * activas a partir de la actual. Después se guardan los resultados, se apuntan las teselas que han
+ * cambiado y se liberan las que se han quedado vacías.
+ */
+void SparseWorld::NextGeneration() {
+  Expand();
+  const std::unordered_set<uint64_t, KeyHash> active = Active();
+  activity_.tiles = tiles_.size();
+  activity_.active = active.size();
+  activity_.evaluated += active.size();
+  activity_.skipped += tiles_.size() - active.size();
+  std::vector<std::pair<uint64_t, Tile>> results;
+  results.reserve(active.size());
+  for (const uint64_t& key : active) {
+    results.emplace_back(key, StepTile(static_cast<int32_t>(key >> 32), static_cast<int32_t>(key), tiles_.at(key)));
+  }
+  changed_.clear();
+  for (const auto& result : results) {
+    Tile& tile = tiles_.at(result.first);
+    long population = 0, difference = 0;
+    for (int i = 0; i < kTileSize; ++i) {
+      population += __builtin_popcountll(result.second[i]);
+      difference += __builtin_popcountll(result.second[i]) - __builtin_popcountll(tile[i]);
+    }
+    if (result.second != tile) {
+      changed_.insert(result.first);
+    }
+    population_ += difference;
+    if (population == 0) {
+      tiles_.erase(result.first);
+    } else {
+      tile = result.second;
+    }
+  }
+}
+
+/**
+ * @brief Método que calcula la siguiente generación de una tesela.
+ * Se copian en una columna de 68 palabras las dos últimas filas de la tesela de arriba, las 64 de la
+ * tesela y las dos primeras de la de abajo; las palabras de izquierda y derecha son las de las
+ * teselas vecinas por esos lados. Con ellas cada fila se calcula con CrossRule como en BitLattice.
+ * @param row fila de la tesela
+ * @param column columna de la tesela
+ * @param tile tesela
+ * @return Tile siguiente generación de la tesela
+ */
+SparseWorld::Tile SparseWorld::StepTile(const int& row, const int& column, const Tile& tile) const {
+  const Tile& north = Find(row - 1, column);
+  const Tile& south = Find(row + 1, column);
+  const Tile& west = Find(row, column - 1);
+  const Tile& east = Find(row, column + 1);
+  uint64_t words[kTileSize + 4];
+  words[0] = north[kTileSize - 2];
+  words[1] = north[kTileSize - 1];
+  std::copy(tile.begin(), tile.end(), words + 2);
+  words[kTileSize + 2] = south[0];
+  words[kTileSize + 3] = south[1];
+  Tile next;
+  for (int i = 0; i < kTileSize; ++i) {
+    next[i] = CrossRule(words[i + 2], west[i], east[i], words[i + 1], words[i], words[i + 3], words[i + 4]);
+  }
+  return next;
+}
+
+/**
+ * @brief Método que calcula el rectángulo que se imprime.
+ * Es el de la configuración inicial ampliado para que quepan todas las células vivas.
+ * @param top primera fila
+ * @param left primera columna
+ * @param bottom última fila
+ * @param right última columna
+ */
+void SparseWorld::Bounds(int& top, int& left, int& bottom, int& right) const {
+  top = 0;
+  left = 0;
+  bottom = rows_ - 1;
+  right = columns_ - 1;
+  for (const auto& entry : tiles_) {
+    const int row = static_cast<int32_t>(entry.first >> 32), column = static_cast<int32_t>(entry.first);
+    for (int i = 0; i < kTileSize; ++i) {
+      const uint64_t word = entry.second[i];
+      if (word != 0) {
+        top = std::min(top, row * kTileSize + i);
+        bottom = std::max(bottom, row * kTileSize + i);
+        left = std::min(left, column * kTileSize + __builtin_ctzll(word));
+        right = std::max(right, column * kTileSize + 63 - __builtin_clzll(word));
+      }
+    }
+  }
+}
+
+/**
+ * @brief Metodo que se encarga de guardar el estado del mundo en un string
+ * Igual que Lattice: una línea por fila, un espacio por célula muerta y una X por célula viva.
+ * @param lattice string al que se añade el mundo
+ * @return std::string el string con el mundo
+ */
+std::string SparseWorld::SaveToString(std::string& lattice) {
+  int top, left, bottom, right;
+  Bounds(top, left, bottom, right);
+  for (int i = top; i <= bottom; ++i) {
+    for (int j = left; j <= right; ++j) {
+      lattice += (getState({i, j}) == DEAD) ? " " : "X";
+    }
+    lattice.push_back('\n');
+  }
+  return lattice;
+}
+
+/**
+ * @brief Sobre carga del operador de inserción
+ * Se imprime el rectángulo con la configuración inicial y todas las células vivas, como el retículo
+ * que crecía con la frontera 'noborder'
+ * @param os flujo de salida
+ * @param world mundo a imprimir
+ * @return std::ostream& flujo de salida
+ */
+std::ostream& operator<<(std::ostream& os, const SparseWorld& world) {
+  int top, left, bottom, right;
+  world.Bounds(top, left, bottom, right);
+  for (int i = top; i <= bottom; ++i) {
+    for (int j = left; j <= right; ++j) {
+      os << ((world.getState({i, j}) == DEAD) ? " " : "X");
+    }
+    os << '\n';
+  }
+  return os;
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+/**
+ * ************ PRÁCTICA 2 *************
+ * @file SparseWorld.h
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-22
+ * @brief Creación de la clase Mundo disperso (retículo sin frontera).
+ * Sustituye al crecimiento del retículo de Lattice::applyBorders con la frontera 'noborder', que
+ * insertaba filas y columnas completas y volvía a colocar todas las células. Aquí el plano infinito se
+ * divide en teselas de 64 x 64 células guardadas como bits (una palabra por fila) en una tabla hash
+ * indexada por la coordenada de la tesela. Solo existen las teselas con células vivas y sus vecinas
+ * necesarias: cuando una célula viva llega al borde de una tesela se crea la de al lado, y las que
+ * se quedan vacías se liberan. Así crecer cuesta O(1) y la memoria depende de la zona viva, no del
+ * rectángulo que la contiene.
+ * En cada generación solo se calculan las teselas que cambiaron en la anterior y sus vecinas, así que
+ * las zonas estables tampoco cuestan nada.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#ifndef SPARSEWORLD_H
+#define SPARSEWORLD_H
+
+#include "BitLattice.h"
+#include "Cell.h"
+
+/**
+ * @brief Clase Mundo disperso
+ * La célula (i, j) está en la tesela (i / 64, j / 64), redondeando hacia abajo también para las
+ * negativas, en el bit j % 64 de la palabra i % 64. Las filas y columnas pueden ser negativas: el
+ * mundo crece en todas direcciones a partir de la configuración inicial, que ocupa las filas
+ * 0 a M - 1 y las columnas 0 a N - 1.
+ */
+class SparseWorld {
+ public:
+  // Constructor para cuando se le pasa -size, pide el estado de cada célula como Lattice
+  SparseWorld(const int& rows, const int& columns);
+  // Constructor para cuando se pasa -init
+  explicit SparseWorld(const std::string& filename);
+  // Getter del número de teselas reservadas
+  std::size_t getTiles() const { return tiles_.size(); }
+  // Getter de las estadísticas de las teselas activas
+  const TileActivity& getActivity() const { return activity_; }
+  // método que devuelve el estado de cualquier célula del plano
+  State getState(const Position&) const;
+  // método modificador para poder establecer la configuración inicial
+  void setState(const Position&, const State&);
+  // método que evoluciona el autómata celular
+  void NextGeneration();
+  std::string SaveToString(std::string& lattice);
+  // Funcion para saber cuantas celulas vivas hay, sin recorrer el mundo
+  std::size_t Population() const { return population_; }
+  // método que imprime el rectángulo con la configuración inicial y todas las células vivas
+  friend std::ostream& operator<<(std::ostream&, const SparseWorld&);
+
+ private:
+  // Células por lado de cada tesela
+  static constexpr int kTileSize = 64;
+  // Tesela: una palabra por fila
+  using Tile = std::array<uint64_t, kTileSize>;
+  /**
+   * @brief Función hash de la coordenada de una tesela (con MixKey)
+   */
+  struct KeyHash {
+    std::size_t operator()(const uint64_t& key) const { return MixKey(key); }
+  };
+  // método que devuelve la tesela o fila de tesela de una célula, redondeando hacia abajo
+  static int TileOf(const int& index) { return index >= 0 ? index / kTileSize : -((kTileSize - 1 - index) / kTileSize); }
+  // método que junta la fila y la columna de una tesela en la clave de la tabla
+  static uint64_t Key(const int& row, const int& column) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(row)) << 32 | static_cast<uint32_t>(column);
+  }
+  // método que devuelve la tesela de una clave, o una vacía si no existe
+  const Tile& Find(const int& row, const int& column) const;
+  // método que crea las teselas vecinas de las cambiadas a las que pueden llegar células vivas
+  void Expand();
+  // método que devuelve las teselas que hay que calcular: las cambiadas y sus vecinas
+  std::unordered_set<uint64_t, KeyHash> Active() const;
+  // método que calcula la siguiente generación de una tesela
+  Tile StepTile(const int& row, const int& column, const Tile& tile) const;
+  // método que calcula el rectángulo que hay que imprimir
+  void Bounds(int& top, int& left, int& bottom, int& right) const;
+  std::unordered_map<uint64_t, Tile, KeyHash> tiles_; // teselas reservadas
+  std::unordered_set<uint64_t, KeyHash> changed_; // teselas que cambiaron en la última generación
+  int rows_; // filas de la configuración inicial
+  int columns_; // columnas de la configuración inicial
+  std::size_t population_ = 0; // número de células vivas
+  TileActivity activity_; // estadísticas de las teselas activas
+};
+
+// Sobrecarga del operador de salida
+std::ostream& operator<<(std::ostream&, const SparseWorld&);
+
+#endif // SPARSEWORLD_H
\ No newline at end of file
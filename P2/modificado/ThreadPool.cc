@@ -0,0 +1,102 @@
+/**
+ * ************ PRÁCTICA 2 *************
+ * @file ThreadPool.cc
+ * @author ALBA PÉREZ RODRÍGUEZ
+ * @version 0.1
+ * @date 2024-02-22
+ * @brief Implementación de los métodos de las clases Barrier y ThreadPool.
+ */
+
+#include "ThreadPool.h"
+
+/**
+ * @brief Método que espera a que lleguen todos los hilos.
+ * El último en llegar ejecuta la función de finalización (si la hay), pasa a la siguiente fase
+ * y despierta a los demás.
+ * @param completion función que se ejecuta una sola vez cuando han llegado todos
+ */
+void Barrier::ArriveAndWait(const std::function<void()>& completion) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const std::size_t phase = phase_;
+  if (++arrived_ == count_) {
+    if (completion) {
+      completion();
+    }
+    arrived_ = 0;
+    ++phase_;
+    condition_.notify_all();
+  } else {
+    condition_.wait(lock, [this, phase] { return phase_ != phase; });
+  }
+}
+
+/**
+ * @brief Construct a new ThreadPool:: ThreadPool object
+ * Crea threads - 1 hilos, ya que el hilo que llama a Run también trabaja.
+ * @param threads número total de hilos
+ */
+ThreadPool::ThreadPool(const std::size_t& threads) {
+  for (std::size_t id = 1; id < threads; ++id) {
+    workers_.emplace_back(&ThreadPool::WorkerLoop, this, id);
+  }
+}
+
+/**
+ * @brief Destroy the ThreadPool:: ThreadPool object
+ * Avisa a los hilos de que terminen y los espera.
+ */
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+/**
+ * @brief Método que ejecuta la tarea en todos los hilos.
+ * El hilo que llama ejecuta task(0) y después espera a que el resto termine.
+ * @param task tarea que recibe el número de hilo
+ */
+void ThreadPool::Run(const std::function<void(std::size_t)>& task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    pending_ = workers_.size();
+    ++round_;
+  }
+  start_.notify_all();
+  task(0);
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this] { return pending_ == 0; });
+  task_ = nullptr;
+}
+
+/**
+ * @brief Bucle de cada hilo persistente.
+ * Espera a que haya una tarea nueva, la ejecuta y avisa cuando termina.
+ * @param id número de hilo
+ */
+void ThreadPool::WorkerLoop(const std::size_t& id) {
+  std::size_t seen = 0;
+  while (true) {
+    const std::function<void(std::size_t)>* task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_.wait(lock, [this, seen] { return stop_ || round_ != seen; });
+      if (stop_) {
+        return;
+      }
+      seen = round_;
+      task = task_;
+    }
+    (*task)(id);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--pending_ == 0) {
+      done_.notify_one();
+    }
+  }
+}
\ No newline at end of file
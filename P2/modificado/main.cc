@@ -15,8 +15,11 @@
 #include <cstring>
 #include <sstream>
 
+#include "BitLattice.h"
 #include "Cell.h"
+#include "HashLife.h"
 #include "Lattice.h"
+#include "SparseWorld.h"
 
 /**
  * @brief Función que imprime el modo de empleo del programa
@@ -30,11 +33,15 @@ void Usage(int argc, char* argv[]) {
     exit(EXIT_FAILURE);
   }
   if ((argc == 2 && std::string(argv[1]) == "--help") || std::string(argv[1]) == "-h") {
-    std::cout << "Modo de empleo: " << argv[0] << " -size <M> <N> -border <type> [0|1] [-init <file>]" << std::endl;
+    std::cout << "Modo de empleo: " << argv[0] << " -size <M> <N> -border <type> [0|1] [-init <file>] [-bitboard [-threads <n>]] [-jump <g>] [-memory <MB>]" << std::endl;
     std::cout << "Donde: " << std::endl;
     std::cout << "  -size <M> <N> : Tamaño del retículo (número de filas M y número de columnas N) obligatorio" << std::endl;
     std::cout << "  -border <type> [0|1]: Tipo de frontera. Puede ser 'open', 'periodic', 'reflective' o 'sin frontera'. Obligatorio." << std::endl;
     std::cout << "  -init <file> : Archivo de configuración inicial (opcional)" << std::endl;
+    std::cout << "  -bitboard : Usa el retículo de bits, 64 células por palabra y 1 bit por célula. Con 'noborder' se usa siempre el mundo disperso por teselas (opcional)" << std::endl;
+    std::cout << "  -threads <n> : Con -bitboard, evoluciona el retículo con n hilos, cada uno con una banda de filas. Por defecto 1 (opcional)" << std::endl;
+    std::cout << "  -jump <g> : Solo con 'noborder'. Usa HashLife y cada generación calculada avanza g generaciones, hasta 2^48 en total (opcional)" << std::endl;
+    std::cout << "  -memory <MB> : Presupuesto de memoria de la caché de nodos de HashLife, 512 MB por defecto (opcional)" << std::endl;
     std::cout << std::endl;
     std::cout << "Funcionalidades del programa:" << std::endl;
     std::cout << "  Este programa se encarga de hacer un autómata celular. Este es un modelo matemático y computacional para un sistema dinámico ";
@@ -46,6 +53,7 @@ void Usage(int argc, char* argv[]) {
     std::cout << "  'n': Calcula y muestra la siguiente generación" << std::endl;
     std::cout << "  'L': Calcula y muestra las siguientes cinco generaciones" << std::endl;
     std::cout << "  'c': Los comandos 'n' y 'L' dejan de mostrar el estado del tablero y sólo se muestra la población" << std::endl;
+    std::cout << "       Con -bitboard o 'noborder' se muestran también las teselas activas y la fracción de teselas saltadas" << std::endl;
     std::cout << "  's': Salva el tablero a un fichero" << std::endl;
     std::cout << std::endl;
     std::cout << "Ejemplo de uso con -size: " << argv[0] << " -size 10 10 -border open 1 " << std::endl;
@@ -61,8 +69,15 @@ void Usage(int argc, char* argv[]) {
  * @param argv es el nombre de los argumentos
  * @param size tamaño del reticulo
  * @param borderType tipo de frontera que se le asigna al retículo por linea de comandos
+ * @param openState estado de las células frontera si la frontera es abierta
+ * @param file_name archivo de configuración inicial
+ * @param bitboard si se usa el retículo de bits
+ * @param threads hilos con los que se evoluciona el retículo de bits
+ * @param jump generaciones que avanza HashLife en cada paso, 0 si no se usa HashLife
+ * @param memory presupuesto de memoria de la caché de nodos de HashLife, en MB
  */
-void checkArgs(int argc, char* argv[], int& row_num, int& column_num, BorderType& bordertype, std::string& file_name) {
+void checkArgs(int argc, char* argv[], int& row_num, int& column_num, BorderType& bordertype, State& openState,
+               std::string& file_name, bool& bitboard, std::size_t& threads, long& jump, std::size_t& memory) {
   // Set default values to row_num and column_num to avoid uninitialized variables
   for (int i = 1; i < argc; i++) {
     std::string arg = argv[i];
@@ -104,6 +119,7 @@ void checkArgs(int argc, char* argv[], int& row_num, int& column_num, BorderType
               std::cerr << "La opción de frontera abierta debe ser 0 o 1" << std::endl;
               exit(EXIT_FAILURE);
             }
+            openState = static_cast<State>(option);
           }
         } else {
           std::cerr << "Tipo de frontera no encontrado. Use '-border <type>'" << std::endl;
@@ -122,6 +138,7 @@ void checkArgs(int argc, char* argv[], int& row_num, int& column_num, BorderType
               std::cerr << "La opción de frontera abierta debe ser 0 o 1" << std::endl;
               exit(EXIT_FAILURE);
             }
+            openState = static_cast<State>(option);
           } else {
             std::cerr << "Opción de frontera abierta no encontrada. Use '-border open <option>'" << std::endl;
             exit(EXIT_FAILURE);
@@ -148,6 +165,33 @@ void checkArgs(int argc, char* argv[], int& row_num, int& column_num, BorderType
         std::cerr << "Archivo de configuración inicial no encontrado. Use '-init <filename>'" << std::endl;
         exit(EXIT_FAILURE);
       }
+    // Retículo de bits
+    } else if (arg == "-bitboard") {
+      bitboard = true;
+    // Hilos del retículo de bits
+    } else if (arg == "-threads") {
+      if (i + 1 < argc && isdigit(argv[i+1][0]) && std::stoi(argv[i+1]) > 0) {
+        threads = std::stoi(argv[++i]);
+      } else {
+        std::cerr << "Número de hilos no válido. Use '-threads <n>' con n > 0" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    // Salto de HashLife
+    } else if (arg == "-jump") {
+      if (i + 1 < argc && isdigit(argv[i+1][0]) && std::stold(argv[i+1]) > 0 && std::stold(argv[i+1]) <= HashLife::kMaxGeneration) {
+        jump = std::stol(argv[++i]);
+      } else {
+        std::cerr << "Número de generaciones del salto no válido. Use '-jump <g>' con 0 < g <= " << HashLife::kMaxGeneration << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    // Memoria de HashLife
+    } else if (arg == "-memory") {
+      if (i + 1 < argc && isdigit(argv[i+1][0]) && std::stoul(argv[i+1]) > 0) {
+        memory = std::stoul(argv[++i]);
+      } else {
+        std::cerr << "Presupuesto de memoria no válido. Use '-memory <MB>' con MB > 0" << std::endl;
+        exit(EXIT_FAILURE);
+      }
     } else {
       std::cerr << "Unrecognized argument: " << arg << std::endl;
       exit(EXIT_FAILURE);
@@ -171,14 +215,44 @@ void SaveToFile(const Lattice& lattice, std::ofstream& output_file) {
   }
 }
 
+/**
+ * @brief Función que muestra las estadísticas de las teselas activas
+ * Lattice calcula todas las células en cada generación, así que no tiene teselas
+ */
+void ShowActivity(const Lattice&) {}
+
+/**
+ * @brief Función que muestra las estadísticas de HashLife
+ * HashLife no tiene teselas: se muestran la generación y el tamaño de la caché de nodos
+ * @param hashlife plano
+ */
+void ShowActivity(const HashLife& hashlife) {
+  std::cout << "Generation: " << hashlife.getGeneration() << ", nodes: " << hashlife.getNodes() << " ("
+            << hashlife.getBytes() / (1024 * 1024) << " MB)" << std::endl;
+}
+
+/**
+ * @brief Función que muestra las estadísticas de las teselas activas
+ * Muestra las teselas calculadas en la última generación y la fracción de teselas saltadas desde el principio.
+ * Sirve para BitLattice y SparseWorld.
+ * @param lattice retículo
+ */
+template <typename LatticeType>
+void ShowActivity(const LatticeType& lattice) {
+  const TileActivity& activity = lattice.getActivity();
+  std::cout << "Active tiles: " << activity.active << " of " << activity.tiles << ", skipped: " << activity.SkipRatio() * 100 << "%" << std::endl;
+}
+
 /**
  * @brief Función que evoluciona el autómata celular
  * Se encarga de evolucionar el autómata celular.
  * La simulación se puede detener en cualquier momento pulsando un carácter elegido como fin de ejecución.
  * En este caso, se detiene la simulación si el usuario pulsa la tecla 'x'.
+ * Sirve para Lattice, BitLattice, SparseWorld y HashLife.
  * @param lattice reticulo a evolucionar 
  */
-void CellEvolution(Lattice& lattice, const std::string& filename = "") {
+template <typename LatticeType>
+void CellEvolution(LatticeType& lattice, const std::string& filename = "") {
   std::string lattice_aux = "";
   // Si no se especifica un nombre de archivo, se guarda en output.txt
   std::string file_name = filename.empty() ? "output.txt" : filename;
@@ -225,6 +299,7 @@ void CellEvolution(Lattice& lattice, const std::string& filename = "") {
       case 'c':
         lattice.Population();
         std::cout << "Population: " << lattice.Population() << std::endl;
+        ShowActivity(lattice);
         break;
       case 's':
         output_file << lattice_aux;
@@ -254,6 +329,11 @@ int main(int argc, char* argv[]) {
   BorderType borderType;
   std::string borderType_aux{argv[4]};
   std::string filename;
+  State openState = DEAD;
+  bool bitboard = false;
+  std::size_t threads = 1;
+  long jump = 0;
+  std::size_t memory = 512;
   // Asignamos el tipo de frontera
   if (borderType_aux == "open") {
     borderType = OPEN;
@@ -265,7 +345,52 @@ int main(int argc, char* argv[]) {
     borderType = NOFRONTER;
   }
   // Comprobamos los argumentos
-  checkArgs(argc, argv, row_num, column_num, borderType, filename);
+  checkArgs(argc, argv, row_num, column_num, borderType, openState, filename, bitboard, threads, jump, memory);
+  if (threads > 1 && (!bitboard || borderType == NOFRONTER || jump > 0)) {
+    std::cerr << "La opción -threads necesita -bitboard y una frontera 'open', 'periodic' o 'reflective'" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  // Con -jump se usa HashLife, que solo sirve para el plano sin frontera
+  if (jump > 0) {
+    if (borderType != NOFRONTER) {
+      std::cerr << "La opción -jump solo se puede usar con la frontera 'noborder'" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (filename.empty()) {
+      HashLife hashlife(row_num, column_num, memory * 1024 * 1024);
+      hashlife.setStep(jump);
+      CellEvolution(hashlife);
+    } else {
+      HashLife hashlife(filename, memory * 1024 * 1024);
+      hashlife.setStep(jump);
+      CellEvolution(hashlife);
+    }
+    return 0;
+  }
+  // Sin frontera, el retículo crece por teselas en un mundo disperso
+  if (borderType == NOFRONTER) {
+    if (filename.empty()) {
+      SparseWorld world(row_num, column_num);
+      CellEvolution(world);
+    } else {
+      SparseWorld world(filename);
+      CellEvolution(world);
+    }
+    return 0;
+  }
+  // Si se pide el retículo de bits, se crea con o sin archivo de configuración inicial
+  if (bitboard) {
+    if (filename.empty()) {
+      BitLattice lattice(row_num, column_num, borderType, openState);
+      lattice.setThreads(threads);
+      CellEvolution(lattice);
+    } else {
+      BitLattice lattice(borderType, openState, filename);
+      lattice.setThreads(threads);
+      CellEvolution(lattice);
+    }
+    return 0;
+  }
   // Si se pasa la opcion -size se llama al constructor con size sin archivo de configuración inicial
   if (filename.empty()) {
     std::cout << std::endl;